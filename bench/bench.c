@@ -0,0 +1,1393 @@
+// Layout benchmarks. Each case builds a synthetic tree in an offscreen window
+// and reports the average time spent in ed_measure and ed_layout during
+// ed_invalidate, taken from `ed_stats.measure_ticks` and `ed_stats.layout_ticks`,
+// and the window changes of the last commit counted by a recording backend.
+// Teardown cases report the time to remove the tree, either as one subtree or
+// one row at a time. Tall content cases check layout beyond 1,000,000 px and
+// make the process exit with 1 if a check fails.
+//
+//     bench.exe [iterations] [--json]
+//
+// With --json every case prints one JSON object per line instead, with the
+// case name, its node or row count and the timings in microseconds, for
+// tracking regressions between runs.
+//
+// Every node owns a window handle, so trees are kept below the default limit
+// of 10,000 USER objects per process. The headless build (bench/make.sh)
+// replaces the window system with headless/win32.c, defines ED_HEADLESS and
+// also runs deeper and larger trees.
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+#include "edwin.h"
+
+struct bench_result {
+    double measure_us;
+    double layout_us;
+    unsigned measured_nodes;
+    unsigned total_nodes;
+    unsigned cache_hits;
+    unsigned cache_lookups;
+};
+
+// Counts the geometry changes of the last commit and forwards them to the
+// default backend.
+struct bench_backend {
+    ed_backend next;
+    unsigned commits; // Calls to begin_commit since the counter was reset
+    unsigned windows;
+    unsigned hidden;  // Windows of the last commit hidden by set_geometry
+    unsigned groups;
+    unsigned scrolls;
+    int scroll_max;   // Arguments of the last set_scroll call
+    int scroll_page;
+    int scroll_pos;
+};
+
+static struct bench_backend recorder;
+
+static double ticks_to_us;
+static int iterations = 20;
+static int failed_checks;
+static bool json;
+
+static long long
+ticks_now(void)
+{
+    LARGE_INTEGER ticks;
+    QueryPerformanceCounter(&ticks);
+    return ticks.QuadPart;
+}
+
+static void
+record_begin_commit(void *user, void *hwnd)
+{
+    ++recorder.commits;
+    recorder.windows = 0;
+    recorder.hidden = 0;
+    recorder.groups = 0;
+    recorder.scrolls = 0;
+    recorder.next.begin_commit(recorder.next.user, hwnd);
+    (void)user;
+}
+
+static void
+record_end_commit(void *user, void *hwnd)
+{
+    recorder.next.end_commit(recorder.next.user, hwnd);
+    (void)user;
+}
+
+static void
+record_begin_group(void *user, void *parent, int count)
+{
+    ++recorder.groups;
+    recorder.next.begin_group(recorder.next.user, parent, count);
+    (void)user;
+}
+
+static void
+record_end_group(void *user, void *parent)
+{
+    recorder.next.end_group(recorder.next.user, parent);
+    (void)user;
+}
+
+static void
+record_set_scroll(void *user, void *hwnd, int max, int page, int pos)
+{
+    ++recorder.scrolls;
+    recorder.scroll_max = max;
+    recorder.scroll_page = page;
+    recorder.scroll_pos = pos;
+    recorder.next.set_scroll(recorder.next.user, hwnd, max, page, pos);
+    (void)user;
+}
+
+static void
+record_set_geometry(void *user, void *hwnd, int x, int y, int w, int h, bool visible)
+{
+    ++recorder.windows;
+    if (!visible) ++recorder.hidden;
+    recorder.next.set_geometry(recorder.next.user, hwnd, x, y, w, h, visible);
+    (void)user;
+}
+
+// Rows of a fixed height, each split into three relatively sized blocks.
+static ed_node *
+build_rows(int node_count)
+{
+    ed_node *block = ed_begin(ED_VERT, 0, 0, 1.0f, 0);
+    for (int n = 1; n + 4 <= node_count; n += 4) {
+        ed_begin(ED_HORZ, 0, 0, 1.0f, 20);
+        {
+            ed_begin(ED_VERT, 0, 0, 0.25f, 1.0f);
+            ed_end();
+            ed_begin(ED_VERT, 0, 0, 0.5f, 1.0f);
+            ed_end();
+            ed_begin(ED_VERT, 0, 0, 0.25f, 1.0f);
+            ed_end();
+        }
+        ed_end();
+    }
+    ed_end();
+    return block;
+}
+
+static void
+mark_subtree_dirty(ed_node *node)
+{
+    ed_mark_dirty(node);
+    for (ed_node *c = node->child; c; c = c->after) {
+        mark_subtree_dirty(c);
+    }
+}
+
+// Invalidates `node` and returns the average time taken. If `full` is set,
+// every node is marked dirty first so the whole tree is measured.
+static struct bench_result
+bench_invalidate(ed_node *node, bool full)
+{
+    struct bench_result result = {0, 0, 0, 0, 0, 0};
+    long long measure_ticks = 0;
+    long long layout_ticks = 0;
+
+    for (int i = 0; i < iterations; ++i) {
+        if (full) mark_subtree_dirty(node);
+        // A layout that moves no window has no commit to count.
+        recorder.windows = 0;
+        recorder.groups = 0;
+        ed_invalidate(node);
+        measure_ticks += ed_stats.measure_ticks;
+        layout_ticks += ed_stats.layout_ticks;
+    }
+
+    result.measure_us = measure_ticks * ticks_to_us / iterations;
+    result.layout_us = layout_ticks * ticks_to_us / iterations;
+    result.measured_nodes = ed_stats.measured_nodes;
+    result.total_nodes = ed_stats.total_nodes;
+    result.cache_hits = ed_stats.measure_cache_hits;
+    result.cache_lookups = ed_stats.measure_cache_lookups;
+    return result;
+}
+
+// Prints a result as one JSON object. `fmt` formats the fields after the case
+// name and count.
+static void
+print_json(const char *name, int count, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    printf("{\"case\":\"%s\",\"count\":%d,", name, count);
+    vprintf(fmt, args);
+    printf("}\n");
+    va_end(args);
+}
+
+static void
+print_result(const char *name, int node_count, struct bench_result result)
+{
+    // Nodes measured and laid out per second of ed_invalidate.
+    double total_us = result.measure_us + result.layout_us;
+    double nodes_per_sec = total_us > 0.0 ? result.measured_nodes * 1e6 / total_us : 0.0;
+
+    if (json) {
+        print_json(name, node_count, "\"measure_us\":%.2f,\"layout_us\":%.2f,"
+                "\"nodes_per_sec\":%.0f,\"measured\":%u,\"total\":%u,"
+                "\"cache_hits\":%u,\"cache_lookups\":%u,\"windows\":%u,\"batches\":%u,"
+                "\"native_skipped\":%u,\"native_calls\":%u",
+                result.measure_us, result.layout_us, nodes_per_sec,
+                result.measured_nodes, result.total_nodes,
+                result.cache_hits, result.cache_lookups,
+                recorder.windows, recorder.groups,
+                ed_stats.native_calls_skipped,
+                ed_stats.native_calls_issued + ed_stats.native_calls_skipped);
+        return;
+    }
+
+    printf("%-24s %8d nodes %12.1f us measure %12.1f us layout %12.0f nodes/s %8u/%u measured"
+            " %8u/%u cache hits %8u windows in %u batches %8u/%u native calls skipped\n",
+            name, node_count, result.measure_us, result.layout_us, nodes_per_sec,
+            result.measured_nodes, result.total_nodes,
+            result.cache_hits, result.cache_lookups,
+            recorder.windows, recorder.groups,
+            ed_stats.native_calls_skipped,
+            ed_stats.native_calls_issued + ed_stats.native_calls_skipped);
+}
+
+static void
+check(bool ok, const char *name, const char *what)
+{
+    if (!ok) {
+        if (json) {
+            printf("{\"case\":\"%s\",\"failed\":\"%s\"}\n", name, what);
+        } else {
+            printf("%-24s FAILED: %s\n", name, what);
+        }
+        ++failed_checks;
+    }
+}
+
+static void
+bench_measure(int node_count)
+{
+    ed_node *block = build_rows(node_count);
+    ed_node *root = ed_index_node(ED_ID_ROOT);
+    print_result("measure_rows", node_count, bench_invalidate(root, true));
+    print_result("measure_rows_clean", node_count, bench_invalidate(root, false));
+    ed_remove(block);
+}
+
+// Rows in a container sized relative to the root, resized along its height
+// only on every iteration. Rows depend on the width of the container alone, so
+// they are not measured again.
+static void
+bench_resize_height(int node_count)
+{
+    ed_node *block = ed_begin(ED_VERT, 0, 0, 1.0f, 1.0f);
+    for (int n = 1; n + 4 <= node_count; n += 4) {
+        ed_begin(ED_HORZ, 0, 0, 1.0f, 20);
+        ed_begin(ED_VERT, 0, 0, 0.25f, 1.0f);
+        ed_end();
+        ed_begin(ED_VERT, 0, 0, 0.5f, 1.0f);
+        ed_end();
+        ed_begin(ED_VERT, 0, 0, 0.25f, 1.0f);
+        ed_end();
+        ed_end();
+    }
+    ed_end();
+
+    struct bench_result result = {0, 0, 0, 0, 0, 0};
+    long long measure_ticks = 0;
+    long long layout_ticks = 0;
+    for (int i = 0; i < iterations; ++i) {
+        block->rect.h = (i & 1) ? 0.5f : 1.0f;
+        ed_invalidate(block->parent);
+        measure_ticks += ed_stats.measure_ticks;
+        layout_ticks += ed_stats.layout_ticks;
+    }
+    result.measure_us = measure_ticks * ticks_to_us / iterations;
+    result.layout_us = layout_ticks * ticks_to_us / iterations;
+    result.measured_nodes = ed_stats.measured_nodes;
+    result.total_nodes = ed_stats.total_nodes;
+    result.cache_hits = ed_stats.measure_cache_hits;
+    result.cache_lookups = ed_stats.measure_cache_lookups;
+    print_result("resize_height", node_count, result);
+    ed_remove(block);
+}
+
+// A single container with `child_count` relatively sized children stacked
+// along its layout axis. Every child needs the child count and its own index
+// to compute its size.
+static void
+bench_container(const char *name, ed_node_layout layout, int child_count)
+{
+    float size = 1.0f / (float)child_count;
+    ed_node *block = ed_begin(layout, 0, 0, 1.0f, 1.0f);
+    for (int i = 0; i < child_count; ++i) {
+        if (layout == ED_HORZ) {
+            ed_begin(ED_VERT, 0, 0, size, 1.0f);
+        } else {
+            ed_begin(ED_HORZ, 0, 0, 1.0f, size);
+        }
+        ed_end();
+    }
+    ed_end();
+
+    print_result(name, child_count + 1, bench_invalidate(block, true));
+    ed_remove(block);
+}
+
+// A chain of `depth` nested containers, each holding a row of three blocks
+// besides the next level. Windows nests child windows only a few dozen levels
+// deep, so this shows the per-level cost of a walk rather than its limit.
+static void
+bench_nested(int depth)
+{
+    ed_node *block = ed_begin(ED_VERT, 0, 0, 1.0f, 0);
+    for (int i = 0; i < depth; ++i) {
+        ed_begin(ED_VERT, 0, 0, 1.0f, 0);
+        ed_begin(ED_HORZ, 0, 0, 1.0f, 20);
+        {
+            ed_begin(ED_VERT, 0, 0, 0.25f, 1.0f);
+            ed_end();
+            ed_begin(ED_VERT, 0, 0, 0.5f, 1.0f);
+            ed_end();
+            ed_begin(ED_VERT, 0, 0, 0.25f, 1.0f);
+            ed_end();
+        }
+        ed_end();
+    }
+    for (int i = 0; i < depth; ++i) {
+        ed_end();
+    }
+    ed_end();
+
+    print_result("measure_nested", depth * 5 + 1, bench_invalidate(block, true));
+    ed_remove(block);
+}
+
+// Hides and shows the middle one of three blocks in a nested block, then
+// invalidates the outer block only. Checks the block after it is placed as
+// if the whole tree had been measured again.
+static void
+check_hide(void)
+{
+    ed_node *block = ed_begin(ED_VERT, 0, 0, 1.0f, 0);
+    ed_begin(ED_VERT, 0, 0, 1.0f, 0);
+    ed_begin(ED_VERT, 0, 0, 1.0f, 20);
+    ed_end();
+    ed_node *b = ed_begin(ED_VERT, 0, 0, 1.0f, 20);
+    ed_end();
+    ed_node *c = ed_begin(ED_VERT, 0, 0, 1.0f, 20);
+    ed_end();
+    ed_end();
+    ed_end();
+    ed_invalidate(block);
+    int shown_y = c->dst.y;
+
+    ed_hide(b);
+    ed_invalidate(block);
+    int hidden_y = c->dst.y;
+    mark_subtree_dirty(block);
+    ed_invalidate(block);
+    check(hidden_y != shown_y && hidden_y == c->dst.y, "hide",
+            "sibling of hidden block not placed again");
+
+    ed_show(b);
+    ed_invalidate(block);
+    check(c->dst.y == shown_y, "hide", "sibling of shown block not placed again");
+    ed_remove(block);
+}
+
+// Lays out labels again without changing them. Checks no commit is made
+// until one of them moves.
+static void
+check_commit(void)
+{
+    ed_node *block = ed_begin(ED_VERT, 0, 0, 1.0f, 0);
+    ed_node *first = ed_label("A");
+    ed_label("B");
+    ed_end();
+    ed_invalidate(block);
+
+    recorder.commits = 0;
+    mark_subtree_dirty(block);
+    ed_invalidate(block);
+    check(recorder.commits == 0 && ed_stats.native_calls_issued == 0, "commit",
+            "layout without changes was committed");
+
+    ed_hide(first);
+    ed_invalidate(block);
+    check(recorder.commits == 1 && recorder.windows > 0, "commit",
+            "moved windows were not committed");
+    ed_remove(block);
+}
+
+// Grows a block inside a block of fixed size, then invalidates the root of
+// the tree. Checks the fixed block is measured again although its parents
+// were not marked.
+static void
+check_reflow(void)
+{
+    ed_node *block = ed_begin(ED_VERT, 0, 0, 1.0f, 0);
+    ed_begin(ED_VERT, 0, 0, 1.0f, 100);
+    ed_node *a = ed_begin(ED_VERT, 0, 0, 1.0f, 20);
+    ed_end();
+    ed_node *b = ed_begin(ED_VERT, 0, 0, 1.0f, 20);
+    ed_end();
+    ed_end();
+    ed_node *c = ed_begin(ED_VERT, 0, 0, 1.0f, 20);
+    ed_end();
+    ed_end();
+    ed_invalidate(block);
+    int c_y = c->dst.y;
+
+    a->rect.h = 40;
+    ed_mark_dirty(a);
+    ed_mark_dirty(a);
+    ed_invalidate(block);
+    check(b->dst.y == a->dst.y + 40 + a->spacing, "reflow",
+            "block inside a fixed block not measured again");
+    check(c->dst.y == c_y, "reflow", "sibling of a fixed block moved");
+    ed_remove(block);
+}
+
+// Grows the first of two blocks in a horizontal scroll client until the
+// scrollbar is shown, then shrinks it again. Checks the block sized relative
+// to the client and the block after it are placed for the new client width.
+static void
+check_scroll(void)
+{
+    ed_node *window = ed_begin_window("Check", ED_VERT, 0, 0, 400, 300);
+    ed_node *block = ed_begin_scroll(ED_HORZ);
+    ed_node *client = block->child;
+    ed_node *a = ed_begin(ED_VERT, 0, 0, 0.5f, 20);
+    ed_end();
+    ed_node *b = ed_begin(ED_VERT, 0, 0, 50, 20);
+    ed_end();
+    ed_end();
+    ed_end();
+    ed_invalidate(window);
+
+    for (int i = 0; i < 2; ++i) {
+        int client_w = client->dst.w;
+        a->rect.h = i == 0 ? 1000.0f : 20.0f;
+        ed_mark_dirty(a);
+        ed_invalidate(window);
+        check(client->dst.w != client_w, "scroll", "scrollbar was not toggled");
+        check(a->dst.w == (client->dst.w - 2 * client->padding - a->spacing) / 2
+                && b->dst.x == a->dst.x + a->dst.w + a->spacing, "scroll",
+                "blocks not placed for the new client width");
+    }
+    ed_remove(window);
+}
+
+// Gives out a handle to a node rebuilt many times. Checks a handle to the
+// first node never resolves to a later one once its slot is reused.
+static void
+check_handles(void)
+{
+    ed_node *block = ed_begin(ED_VERT, 0, 0, 1.0f, 0);
+    ed_end();
+    ed_handle first = ed_get_handle(block);
+    ed_remove(block);
+
+    bool resolved = false;
+    for (int i = 0; i < 3000; ++i) {
+        block = ed_begin(ED_VERT, 0, 0, 1.0f, 0);
+        ed_end();
+        ed_get_handle(block);
+        if (ed_resolve(first)) resolved = true;
+        ed_remove(block);
+    }
+    check(!resolved, "handles", "stale handle resolved to a later node");
+}
+
+static int
+count_nodes(ed_node *node)
+{
+    int count = 1;
+    for (ed_node *c = node->child; c; c = c->after) {
+        count += count_nodes(c);
+    }
+    return count;
+}
+
+// Groups of labelled inputs, each holding a nested group, like a property
+// panel with collapsible sections.
+static void
+bench_groups(int group_count)
+{
+    ed_node *block = ed_begin(ED_VERT, 0, 0, 1.0f, 0);
+    for (int g = 0; g < group_count; ++g) {
+        ed_begin_group("Group", ED_VERT, 0, 0, 1.0f, 0);
+        for (int i = 0; i < 4; ++i) {
+            ed_float("Value", 0.0f, 1.0f);
+        }
+        ed_begin_group("Nested", ED_VERT, 0, 0, 1.0f, 0);
+        for (int i = 0; i < 4; ++i) {
+            ed_int("Count", 0, 100);
+        }
+        ed_end();
+        ed_end();
+    }
+    ed_end();
+
+    print_result("groups", count_nodes(block), bench_invalidate(block, true));
+    ed_remove(block);
+}
+
+// An n by n matrix of cells, built either as a row of column blocks like
+// ed_matrix was before grid layouts, or as one ED_GRID block. Reports the node
+// count of each and the time to measure them.
+static void
+bench_matrix(int n, bool grid)
+{
+    ed_node *block = ed_begin(ED_HORZ, 0, 0, 1.0f, 0);
+    if (grid) {
+        ed_begin_grid(n, NULL, 0, 0, 1.0f, 0);
+        for (int i = 0; i < n * n; ++i) {
+            ed_push_rect(0, 0, 1.0f, 20);
+            ed_label("0.000");
+        }
+        ed_end();
+    } else {
+        ed_begin(ED_HORZ, 0, 0, 1.0f, 0);
+        for (int i = 0; i < n; ++i) {
+            ed_begin(ED_VERT, 0, 0, 1.0f / (float)n, 0);
+            for (int j = 0; j < n; ++j) {
+                ed_push_rect(0, 0, 1.0f, 20);
+                ed_label("0.000");
+            }
+            ed_end();
+        }
+        ed_end();
+    }
+    ed_end();
+
+    print_result(grid ? "matrix_grid" : "matrix_nested", count_nodes(block),
+            bench_invalidate(block, true));
+    ed_remove(block);
+}
+
+// A vector of n labelled elements, built either as a row block per element
+// like ed_vector was before grid layouts, or as one two column ED_GRID block.
+static void
+bench_vector(int n, bool grid)
+{
+    ed_node *block = ed_begin(ED_VERT, 0, 0, 1.0f, 0);
+    if (grid) {
+        float weights[2] = {20.0f, 1.0f};
+        ed_begin_grid(2, weights, 0, 0, 1.0f, 0);
+    } else {
+        ed_begin(ED_VERT, 0, 0, 1.0f, 0);
+    }
+    for (int i = 0; i < n; ++i) {
+        if (!grid) ed_begin(ED_HORZ, 0, 0, 1.0f, 0);
+        ed_push_rect(0, 0, 20, 20);
+        ed_label("x");
+        ed_push_rect(0, 0, 1.0f, 20);
+        ed_label("0.000");
+        if (!grid) ed_end();
+    }
+    ed_end();
+    ed_end();
+
+    print_result(grid ? "vector_grid" : "vector_nested", count_nodes(block),
+            bench_invalidate(block, true));
+    ed_remove(block);
+}
+
+// Cells of different heights in a three column grid. Checks each row starts
+// below the tallest cell of the row before.
+static void
+check_grid(void)
+{
+    static const int heights[] = {20, 40, 10, 15, 15, 15, 20};
+    ed_node *cells[7];
+
+    ed_node *block = ed_begin_grid(3, NULL, 0, 0, 1.0f, 0);
+    for (int i = 0; i < 7; ++i) {
+        ed_push_rect(0, 0, 1.0f, (float)heights[i]);
+        cells[i] = ed_label("0");
+    }
+    ed_end();
+    ed_invalidate(block);
+
+    int spacing = ed_style.spacing;
+    check(cells[2]->dst.y == cells[0]->dst.y
+            && cells[3]->dst.y == cells[0]->dst.y + 40 + spacing
+            && cells[6]->dst.y == cells[3]->dst.y + 15 + spacing, "grid",
+            "row not placed below the tallest cell before");
+
+    // Cells measured on their own, like a label whose text changed.
+    int row_y = cells[3]->dst.y;
+    ed_invalidate(cells[3]);
+    ed_invalidate(cells[4]);
+    ed_invalidate(cells[6]);
+    check(cells[3]->dst.y == row_y && cells[4]->dst.y == row_y
+            && cells[6]->dst.y == row_y + 15 + spacing, "grid",
+            "cell measured on its own moved");
+    ed_remove(block);
+}
+
+// Eight tool windows placed side by side in the root.
+static void
+bench_windows(int node_count)
+{
+    ed_node *windows[8];
+    int window_count = (int)(sizeof windows / sizeof *windows);
+    for (int w = 0; w < window_count; ++w) {
+        windows[w] = ed_begin_window("Bench", ED_VERT, (float)(w * 150), 0, 150, 600);
+        for (int n = 1; n + 4 <= node_count / window_count; n += 4) {
+            ed_begin(ED_HORZ, 0, 0, 1.0f, 20);
+            ed_begin(ED_VERT, 0, 0, 0.25f, 1.0f);
+            ed_end();
+            ed_begin(ED_VERT, 0, 0, 0.5f, 1.0f);
+            ed_end();
+            ed_begin(ED_VERT, 0, 0, 0.25f, 1.0f);
+            ed_end();
+            ed_end();
+        }
+        ed_end();
+    }
+
+    ed_node *root = ed_index_node(ED_ID_ROOT);
+    print_result("windows", node_count, bench_invalidate(root, true));
+
+    for (int w = 0; w < window_count; ++w) {
+        ed_remove(windows[w]);
+    }
+}
+
+static void
+build_list_row(ed_node *row)
+{
+    (void)row;
+    ed_label("");
+}
+
+static void
+bind_list_row(ed_node *row, int index)
+{
+    char text[32];
+    snprintf(text, sizeof text, "Row %d", index);
+    SetWindowTextA(ed_hwnd(row->child), text);
+}
+
+// Shrinks a virtual list below its number of row slots and grows it again.
+// Checks the slots without a row are hidden and shown by the commit.
+static void
+check_list(void)
+{
+    ed_node *list = ed_list(100, 20, build_list_row, bind_list_row);
+    ed_invalidate(ed_index_node(ED_ID_ROOT));
+    ed_node *last = list->child->child;
+    unsigned slot_count = 1;
+    while (last->after) {
+        last = last->after;
+        ++slot_count;
+    }
+
+    // The scrollbar is hidden as well.
+    ed_list_set_count(list, 3);
+    check(!ed_is_visible(last) && recorder.hidden == slot_count - 3 + 1, "list",
+            "slot without a row was not hidden by the commit");
+
+    ed_list_set_count(list, 100);
+    check(ed_is_visible(last) && recorder.hidden == 0, "list",
+            "slot bound again was not shown by the commit");
+    ed_remove(list);
+}
+
+// A virtual list of `row_count` rows scrolled from top to bottom one line at a
+// time. Reports the average time per scroll step and the number of nodes
+// kept alive by the list.
+static void
+bench_list(int row_count)
+{
+    long long start = ticks_now();
+    ed_node *list = ed_list(row_count, 20, build_list_row, bind_list_row);
+    ed_invalidate(ed_index_node(ED_ID_ROOT));
+    double create_us = (ticks_now() - start) * ticks_to_us;
+
+    int steps = 0;
+    start = ticks_now();
+    for (int i = 0; i < iterations * 50; ++i) {
+        SendMessageA(ed_hwnd(list), WM_VSCROLL, SB_LINEDOWN, 0);
+        ++steps;
+    }
+    double scroll_us = (ticks_now() - start) * ticks_to_us / steps;
+    ed_invalidate(list);
+
+    if (json) {
+        print_json("list_scroll", row_count, "\"create_us\":%.2f,\"scroll_us\":%.2f,\"total\":%u",
+                create_us, scroll_us, ed_get_stats()->total_nodes);
+    } else {
+        printf("%-24s %8d rows  %12.1f us create  %12.1f us/scroll %8u nodes\n",
+                "list_scroll", row_count, create_us, scroll_us,
+                ed_get_stats()->total_nodes);
+    }
+    ed_remove(list);
+}
+
+// Rows inside a scrolling window, resized so the scrollbar is toggled on
+// every iteration. The measured node count shows whether the client was
+// measured more than once.
+static void
+bench_scroll(int node_count)
+{
+    ed_node *window = ed_begin_window("Bench", ED_VERT, 0, 0, 400, 300);
+    for (int n = 1; n + 4 <= node_count; n += 4) {
+        ed_begin(ED_HORZ, 0, 0, 1.0f, 20);
+        ed_begin(ED_VERT, 0, 0, 0.25f, 1.0f);
+        ed_end();
+        ed_begin(ED_VERT, 0, 0, 0.5f, 1.0f);
+        ed_end();
+        ed_begin(ED_VERT, 0, 0, 0.25f, 1.0f);
+        ed_end();
+        ed_end();
+    }
+    ed_end();
+
+    struct bench_result result = {0, 0, 0, 0, 0, 0};
+    long long measure_ticks = 0;
+    long long layout_ticks = 0;
+    for (int i = 0; i < iterations; ++i) {
+        // Tall enough to fit every row on odd iterations.
+        window->rect.h = (i & 1) ? (float)(node_count / 4 * 20 + 100) : 300.0f;
+        ed_invalidate(window);
+        measure_ticks += ed_stats.measure_ticks;
+        layout_ticks += ed_stats.layout_ticks;
+    }
+    result.measure_us = measure_ticks * ticks_to_us / iterations;
+    result.layout_us = layout_ticks * ticks_to_us / iterations;
+    result.measured_nodes = ed_stats.measured_nodes;
+    result.total_nodes = ed_stats.total_nodes;
+    print_result("scroll_resize", node_count, result);
+    ed_remove(window);
+}
+
+// Scrolls `block` down with the mouse wheel until it stops moving.
+static void
+scroll_to_bottom(ed_node *block)
+{
+    // Largest wheel delta that fits in the message.
+    WPARAM wheel = MAKEWPARAM(0, (WORD)(-32640));
+    for (int i = 0; i < 100000; ++i) {
+        ed_node *client = block->child;
+        int before = client->scroll_pos;
+        RECT rect;
+        GetWindowRect(ed_hwnd(client->child), &rect);
+        SendMessageA(ed_hwnd(block), WM_MOUSEWHEEL, wheel, 0);
+        RECT moved;
+        GetWindowRect(ed_hwnd(client->child), &moved);
+        if (client->scroll_pos == before && moved.top == rect.top) break;
+    }
+}
+
+// A scroll client with rows adding up to more than 1,000,000 px. Checks the
+// content height is not truncated and the client scrolls to its last row.
+static void
+bench_tall_scroll(int row_count, int row_height)
+{
+    ed_node *block = ed_begin_scroll(ED_VERT);
+    ed_node *client = block->child;
+    ed_node *last = NULL;
+    for (int i = 0; i < row_count; ++i) {
+        last = ed_begin(ED_HORZ, 0, 0, 1.0f, (float)row_height);
+        ed_end();
+    }
+    ed_end();
+
+    struct bench_result result = bench_invalidate(block, true);
+    print_result("tall_scroll", row_count, result);
+
+    long long content = (long long)row_count * row_height;
+    check(content > 1000000, "tall_scroll", "content is not taller than 1,000,000 px");
+    check(last->dst.y + last->dst.h >= content, "tall_scroll", "last row is not below the content");
+    check(client->bounds.h >= content, "tall_scroll", "bounds are truncated");
+    check(recorder.scroll_max == client->bounds.h, "tall_scroll", "scrollbar range is truncated");
+
+    scroll_to_bottom(block);
+    check(client->scroll_pos == client->bounds.h - client->dst.h, "tall_scroll",
+            "client did not scroll to the bottom");
+    ed_remove(block);
+}
+
+// A virtual list with rows adding up to more than 1,000,000 px, scrolled to
+// the bottom. Checks the last row is bound and placed at the bottom of the view.
+static void
+bench_tall_list(int row_count)
+{
+    ed_node *block = ed_list(row_count, 20, build_list_row, bind_list_row);
+    ed_node *client = block->child;
+    ed_invalidate(ed_index_node(ED_ID_ROOT));
+    check(recorder.scroll_max >= row_count * 20, "tall_list", "scrollbar range is truncated");
+
+    // Virtual lists keep the position in the list state, scroll until the
+    // rows stop moving.
+    long long start = ticks_now();
+    scroll_to_bottom(block);
+    double scroll_us = (ticks_now() - start) * ticks_to_us;
+
+    ed_node *bottom = client->child;
+    for (ed_node *row = client->child; row; row = row->after) {
+        if (row->dst.y > bottom->dst.y) bottom = row;
+    }
+    char text[32];
+    GetWindowTextA(ed_hwnd(bottom->child), text, sizeof text);
+    char expected[32];
+    snprintf(expected, sizeof expected, "Row %d", row_count - 1);
+    check(strcmp(text, expected) == 0, "tall_list", "last row is not bound");
+    check(bottom->dst.y + bottom->dst.h + client->padding == client->dst.h, "tall_list",
+            "last row is not at the bottom of the view");
+
+    if (json) {
+        print_json("tall_list", row_count, "\"scroll_us\":%.2f", scroll_us);
+    } else {
+        printf("%-24s %8d rows  %12.1f us to scroll to bottom\n", "tall_list", row_count, scroll_us);
+    }
+    ed_remove(block);
+}
+
+// Sets the text of an auto-sized label in the last row every iteration, like
+// a readout updated each frame.
+static void
+bench_label(int node_count)
+{
+    ed_node *block = build_rows(node_count);
+    ed_node *row = block->child;
+    while (row->after) row = row->after;
+
+    ed_begin_context(row->child);
+    ed_node *label = ed_label("0");
+    ed_end_context();
+
+    long long ticks = 0;
+    for (int i = 0; i < iterations; ++i) {
+        char text[16];
+        snprintf(text, sizeof text, "%d", i * 1111);
+
+        LARGE_INTEGER start, end;
+        QueryPerformanceCounter(&start);
+        SetWindowTextA((HWND)label->hwnd, text);
+        QueryPerformanceCounter(&end);
+        ticks += end.QuadPart - start.QuadPart;
+    }
+
+    double update_us = ticks * ticks_to_us / iterations;
+    if (json) {
+        print_json("label_update", node_count, "\"update_us\":%.2f,\"measured\":%u,\"total\":%u",
+                update_us, ed_stats.measured_nodes, ed_stats.total_nodes);
+    } else {
+        printf("%-24s %8d nodes %12.1f us update   %8u/%u measured\n", "label_update",
+                node_count, update_us, ed_stats.measured_nodes, ed_stats.total_nodes);
+    }
+    ed_remove(block);
+}
+
+// A vector of `count` float inputs with one value in a hundred changing every
+// frame, refreshed by ed_data on the whole vector and then by ed_sync on the
+// same values bound with ed_bind. Checks ed_sync refreshes exactly the changed
+// nodes.
+static void
+bench_sync(int count)
+{
+    float *values = (float *)calloc(count, sizeof(float));
+    ed_node *block = ed_begin(ED_VERT, 0, 0, 1.0f, 0);
+    ed_node *first = ed_vector(NULL, ED_FLOAT, count);
+    ed_end();
+    ed_data(first, values);
+
+    long long data_ticks = 0;
+    for (int i = 0; i < iterations; ++i) {
+        for (int j = i % 100; j < count; j += 100) values[j] += 1.0f;
+        long long start = ticks_now();
+        ed_data(first, values);
+        data_ticks += ticks_now() - start;
+    }
+
+    ed_bind(first, values);
+    ed_sync();
+    check(ed_stats.sync_refreshed == 0, "sync", "unchanged values refreshed on bind");
+
+    long long sync_ticks = 0;
+    int changed = 0;
+    int last = 0;
+    for (int i = 0; i < iterations; ++i) {
+        changed = 0;
+        for (int j = i % 100; j < count; j += 100, ++changed) {
+            values[j] += 1.0f;
+            last = j;
+        }
+        long long start = ticks_now();
+        ed_sync();
+        sync_ticks += ticks_now() - start;
+    }
+    check(ed_stats.sync_compared == (unsigned)count, "sync", "bindings missing from the table");
+    check(ed_stats.sync_refreshed == (unsigned)changed, "sync", "unchanged nodes refreshed");
+
+    ed_node *node = first;
+    for (int j = 0; j < last; ++j) node = ed_binding(node)->node_list;
+    char expected[64];
+    char text[64];
+    snprintf(expected, sizeof expected, ed_style.value_formats[ED_FLOAT], values[last]);
+    GetWindowTextA(ed_hwnd(node), text, sizeof text);
+    check(strcmp(text, expected) == 0, "sync", "changed value not displayed");
+
+    double data_us = data_ticks * ticks_to_us / iterations;
+    double sync_us = sync_ticks * ticks_to_us / iterations;
+    if (json) {
+        print_json("sync", count, "\"data_us\":%.2f,\"sync_us\":%.2f,\"refreshed\":%u",
+                data_us, sync_us, ed_stats.sync_refreshed);
+    } else {
+        printf("%-24s %8d values %11.1f us ed_data %10.1f us ed_sync %8u refreshed\n", "sync",
+                count, data_us, sync_us, ed_stats.sync_refreshed);
+    }
+
+    ed_remove(block);
+    ed_sync();
+    check(ed_stats.sync_compared == 0, "sync", "removed nodes still bound");
+    free(values);
+}
+
+// A vector of `count` float inputs that does not change between frames,
+// compared by ed_data and skipped by ed_sync after ed_bind_version. Checks the
+// vector is only refreshed once its version moves.
+static void
+bench_sync_version(int count)
+{
+    float *values = (float *)calloc(count, sizeof(float));
+    unsigned long long version = 0;
+    ed_node *block = ed_begin(ED_VERT, 0, 0, 1.0f, 0);
+    ed_node *first = ed_vector(NULL, ED_FLOAT, count);
+    ed_end();
+    ed_data(first, values);
+
+    long long data_ticks = 0;
+    for (int i = 0; i < iterations; ++i) {
+        long long start = ticks_now();
+        ed_data(first, values);
+        data_ticks += ticks_now() - start;
+    }
+
+    ed_bind_version(first, values, 0, &version);
+    ed_sync();
+
+    long long sync_ticks = 0;
+    for (int i = 0; i < iterations; ++i) {
+        long long start = ticks_now();
+        ed_sync();
+        sync_ticks += ticks_now() - start;
+    }
+    check(ed_stats.sync_refreshed == 0, "sync_version", "unchanged version refreshed");
+
+    values[count - 1] = 1.0f;
+    ++version;
+    ed_sync();
+    check(ed_stats.sync_refreshed == 1, "sync_version", "moved version not refreshed");
+
+    ed_node *node = first;
+    while (ed_binding(node)->node_list) node = ed_binding(node)->node_list;
+    char expected[64];
+    char text[64];
+    snprintf(expected, sizeof expected, ed_style.value_formats[ED_FLOAT], values[count - 1]);
+    GetWindowTextA(ed_hwnd(node), text, sizeof text);
+    check(strcmp(text, expected) == 0, "sync_version", "changed value not displayed");
+
+    double data_us = data_ticks * ticks_to_us / iterations;
+    double sync_us = sync_ticks * ticks_to_us / iterations;
+    if (json) {
+        print_json("sync_version", count, "\"data_us\":%.2f,\"sync_us\":%.2f", data_us, sync_us);
+    } else {
+        printf("%-24s %8d values %11.1f us ed_data %10.1f us ed_sync\n", "sync_version",
+                count, data_us, sync_us);
+    }
+
+    ed_remove(block);
+    free(values);
+}
+
+// A vector of `count` float inputs bound with ed_data, with a run of 16 values
+// overwritten every frame. Compares ed_data on the whole vector with
+// ed_notify_range on the run and ed_update. Checks only the run is refreshed.
+static void
+bench_notify(int count)
+{
+    enum { RUN = 16 };
+    float *values = (float *)calloc(count, sizeof(float));
+    float run[RUN];
+
+    ed_node *block = ed_begin(ED_VERT, 0, 0, 1.0f, 0);
+    ed_node *first = ed_vector(NULL, ED_FLOAT, count);
+    ed_end();
+    ed_data(first, values);
+
+    // Sorts the ranges added by ed_data, once per change of value pointers.
+    ed_notify_range(values, 0);
+
+    long long data_ticks = 0;
+    long long notify_ticks = 0;
+    int offset = 0;
+    for (int i = 0; i < iterations; ++i) {
+        for (int j = 0; j < RUN; ++j) run[j] = (float)(i * RUN + j);
+
+        offset = (i * RUN) % (count - RUN + 1);
+        memcpy(values + offset, run, sizeof run);
+        long long start = ticks_now();
+        ed_data(first, values);
+        data_ticks += ticks_now() - start;
+
+        for (int j = 0; j < RUN; ++j) run[j] += 0.5f;
+        memcpy(values + offset, run, sizeof run);
+        start = ticks_now();
+        ed_notify_range(values + offset, sizeof run);
+        ed_update(1);
+        notify_ticks += ticks_now() - start;
+    }
+    check(ed_stats.notify_refreshed == RUN, "notify", "nodes outside the range refreshed");
+
+    ed_node *node = first;
+    for (int j = 0; j < offset + RUN - 1; ++j) node = ed_binding(node)->node_list;
+    char expected[64];
+    char text[64];
+    snprintf(expected, sizeof expected, ed_style.value_formats[ED_FLOAT], values[offset + RUN - 1]);
+    GetWindowTextA(ed_hwnd(node), text, sizeof text);
+    check(strcmp(text, expected) == 0, "notify", "changed value not displayed");
+
+    // One byte at the end of a value still overlaps it.
+    ed_notify_range((char *)(values + count) - 1, 1);
+    ed_update(1);
+    check(ed_stats.notify_refreshed == 1, "notify", "partial overlap not refreshed");
+
+    double data_us = data_ticks * ticks_to_us / iterations;
+    double notify_us = notify_ticks * ticks_to_us / iterations;
+    if (json) {
+        print_json("notify", count, "\"data_us\":%.2f,\"notify_us\":%.2f", data_us, notify_us);
+    } else {
+        printf("%-24s %8d values %11.1f us ed_data %10.1f us notify\n", "notify",
+                count, data_us, notify_us);
+    }
+
+    ed_remove(block);
+    free(values);
+}
+
+// `count` string readouts passed to ed_str_data every frame, with one in ten
+// changing. Checks the changed strings are displayed.
+static void
+bench_text(int count)
+{
+    enum { TEXT_SIZE = 32 };
+    char *texts = (char *)calloc(count, TEXT_SIZE);
+    ed_node **nodes = (ed_node **)calloc(count, sizeof(ed_node *));
+    ed_node *block = ed_begin(ED_VERT, 0, 0, 1.0f, 0);
+    for (int i = 0; i < count; ++i) {
+        ed_push_rect(0, 0, 1.0f, 20);
+        nodes[i] = ed_text(NULL);
+        snprintf(texts + i * TEXT_SIZE, TEXT_SIZE, "entity %d", i);
+        ed_str_data(nodes[i], texts + i * TEXT_SIZE, TEXT_SIZE);
+    }
+    ed_end();
+
+    long long ticks = 0;
+    for (int i = 0; i < iterations; ++i) {
+        for (int j = i % 10; j < count; j += 10) {
+            snprintf(texts + j * TEXT_SIZE, TEXT_SIZE, "entity %d frame %d", j, i);
+        }
+        long long start = ticks_now();
+        for (int j = 0; j < count; ++j) {
+            ed_str_data(nodes[j], texts + j * TEXT_SIZE, TEXT_SIZE);
+        }
+        ticks += ticks_now() - start;
+    }
+
+    char text[TEXT_SIZE];
+    int last = count - 1;
+    GetWindowTextA(ed_hwnd(nodes[last]), text, sizeof text);
+    check(strcmp(text, texts + last * TEXT_SIZE) == 0, "text_data", "changed text not displayed");
+
+    double data_us = ticks * ticks_to_us / iterations;
+    if (json) {
+        print_json("text_data", count, "\"data_us\":%.2f", data_us);
+    } else {
+        printf("%-24s %8d values %11.1f us ed_data\n", "text_data", count, data_us);
+    }
+
+    ed_remove(block);
+    free(nodes);
+    free(texts);
+}
+
+static unsigned cheap_calls;
+static unsigned expensive_calls;
+
+static void
+spin_us(double us)
+{
+    long long start = ticks_now();
+    while ((ticks_now() - start) * ticks_to_us < us) {
+    }
+}
+
+static void
+cheap_update(void)
+{
+    spin_us(20.0);
+    ++cheap_calls;
+}
+
+static void
+expensive_update(void)
+{
+    spin_us(2000.0);
+    ++expensive_calls;
+}
+
+// `count` update functions of 20 us and one of 2 ms, called by
+// ed_update_budget with a 1 ms budget. Checks every function is called at
+// least once every `max_wait` frames.
+static void
+bench_update_budget(int count, unsigned max_wait)
+{
+    const int frames = 64;
+    const unsigned budget_us = 1000;
+    cheap_calls = 0;
+    expensive_calls = 0;
+
+    ed_register_update(NULL, expensive_update);
+    for (int i = 0; i < count; ++i) {
+        ed_register_update(NULL, cheap_update);
+    }
+
+    long long ticks = 0;
+    long long max_ticks = 0;
+    bool waited_too_long = false;
+    for (int frame = 0; frame < frames; ++frame) {
+        ed_update_budget(budget_us, max_wait);
+        ticks += ed_stats.update_ticks;
+        if (ed_stats.update_ticks > max_ticks) max_ticks = ed_stats.update_ticks;
+
+        for (int i = 0; i < count + 1; ++i) {
+            if (ed_stats.update_calls - ed_update_funcs[i].last_frame >= max_wait) {
+                waited_too_long = true;
+            }
+        }
+    }
+    check(!waited_too_long, "update_budget", "update function waited too many frames");
+    check(expensive_calls >= frames / max_wait, "update_budget", "expensive function starved");
+
+    double frame_us = ticks * ticks_to_us / frames;
+    double max_us = max_ticks * ticks_to_us;
+    double calls_per_frame = (double)(cheap_calls + expensive_calls) / frames;
+    if (json) {
+        print_json("update_budget", count + 1, "\"frame_us\":%.2f,\"max_frame_us\":%.2f,"
+                "\"calls_per_frame\":%.2f,\"expensive_calls\":%u,\"expensive_cost_us\":%.2f",
+                frame_us, max_us, calls_per_frame, expensive_calls, ed_stats.update_cost_us[0]);
+    } else {
+        printf("%-24s %8d funcs %12.1f us frame %10.1f us max %8.2f calls/frame"
+                " %6u expensive calls %10.1f us expensive cost\n", "update_budget",
+                count + 1, frame_us, max_us, calls_per_frame, expensive_calls,
+                ed_stats.update_cost_us[0]);
+    }
+
+    ed_unregister_update(NULL);
+}
+
+// Rebuilds half of the rows of a tree to scatter nodes across the node table,
+// then compares layout times before and after ed_compact.
+static void
+bench_compact(int node_count)
+{
+    build_rows(node_count);
+    ed_node *root = ed_index_node(ED_ID_ROOT);
+
+    for (int pass = 0; pass < 4; ++pass) {
+        ed_node *block = root->child;
+        while (block->after) block = block->after;
+
+        int removed = 0;
+        for (ed_node *row = block->child; row && row->after; row = row->after) {
+            ed_remove(row->after);
+            ++removed;
+        }
+
+        ed_begin_context(block);
+        for (int i = 0; i < removed; ++i) {
+            ed_begin(ED_HORZ, 0, 0, 1.0f, 20);
+            ed_begin(ED_VERT, 0, 0, 0.25f, 1.0f);
+            ed_end();
+            ed_begin(ED_VERT, 0, 0, 0.5f, 1.0f);
+            ed_end();
+            ed_begin(ED_VERT, 0, 0, 0.25f, 1.0f);
+            ed_end();
+            ed_end();
+        }
+        ed_end_context();
+    }
+
+    print_result("measure_fragmented", node_count, bench_invalidate(root, true));
+    ed_compact();
+
+    // Compaction moved every node, including the root.
+    root = ed_index_node(ED_ID_ROOT);
+    print_result("measure_compacted", node_count, bench_invalidate(root, true));
+    if (json) {
+        print_json("fragmentation", node_count, "\"before\":%.3f,\"after\":%.3f",
+                ed_stats.fragmentation_before, ed_stats.fragmentation_after);
+    } else {
+        printf("%-24s %8d nodes %12.3f before %12.3f after\n", "fragmentation",
+                node_count, ed_stats.fragmentation_before, ed_stats.fragmentation_after);
+    }
+
+    ed_node *block = root->child;
+    while (block->after) block = block->after;
+    ed_remove(block);
+}
+
+static void
+print_teardown(const char *name, int node_count, double us)
+{
+    if (json) {
+        print_json(name, node_count, "\"total_us\":%.2f,\"node_us\":%.4f", us, us / node_count);
+        return;
+    }
+    printf("%-24s %8d nodes %12.1f us total  %12.3f us/node\n",
+            name, node_count, us, us / node_count);
+}
+
+// Removes the whole tree with a single ed_remove.
+static void
+bench_remove_subtree(int node_count)
+{
+    long long ticks = 0;
+    for (int i = 0; i < iterations; ++i) {
+        ed_node *block = build_rows(node_count);
+        long long start = ticks_now();
+        ed_remove(block);
+        ticks += ticks_now() - start;
+    }
+    print_teardown("remove_subtree", node_count, ticks * ticks_to_us / iterations);
+}
+
+// Removes each row separately, which destroys one window and invalidates the
+// parent for every row.
+static void
+bench_remove_rows(int node_count)
+{
+    long long ticks = 0;
+    for (int i = 0; i < iterations; ++i) {
+        ed_node *block = build_rows(node_count);
+        long long start = ticks_now();
+        while (block->child) {
+            ed_remove(block->child);
+        }
+        ticks += ticks_now() - start;
+        ed_remove(block);
+    }
+    print_teardown("remove_rows", node_count, ticks * ticks_to_us / iterations);
+}
+
+int
+main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else {
+            iterations = atoi(argv[i]);
+            if (iterations < 1) iterations = 1;
+        }
+    }
+
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    ticks_to_us = 1e6 / (double)freq.QuadPart;
+
+    WNDCLASSA wndclass = {0};
+    wndclass.lpfnWndProc   = DefWindowProcA;
+    wndclass.hInstance     = GetModuleHandleA(NULL);
+    wndclass.lpszClassName = "ED_BENCH";
+    RegisterClassA(&wndclass);
+
+    // Visible but offscreen, hidden nodes are skipped by ed_measure.
+    HWND hwnd = CreateWindowA("ED_BENCH", "Edwin Bench",
+            WS_OVERLAPPEDWINDOW | WS_VISIBLE, -4000, -4000, 1280, 720,
+            NULL, NULL, wndclass.hInstance, NULL);
+
+    ed_init(hwnd);
+
+    ed_backend record = {
+        NULL, record_begin_commit, record_end_commit,
+        record_begin_group, record_end_group, record_set_geometry,
+        record_set_scroll,
+    };
+    recorder.next = *ed_get_backend();
+    ed_set_backend(&record);
+
+    bench_measure(1000);
+    bench_measure(4000);
+    bench_measure(9000);
+#ifdef ED_HEADLESS
+    bench_measure(10000);
+    bench_measure(100000);
+#endif
+
+    bench_resize_height(1000);
+    bench_resize_height(8000);
+
+    // Sizes are capped by the USER object quota, see above.
+    int container_sizes[] = {10, 100, 1000, 9000};
+    for (int i = 0; i < (int)(sizeof container_sizes / sizeof *container_sizes); ++i) {
+        bench_container("container_horz", ED_HORZ, container_sizes[i]);
+    }
+    for (int i = 0; i < (int)(sizeof container_sizes / sizeof *container_sizes); ++i) {
+        bench_container("container_vert", ED_VERT, container_sizes[i]);
+    }
+
+#ifdef ED_HEADLESS
+    // Beyond the USER object quota, shows sibling placement stays linear.
+    bench_container("container_horz", ED_HORZ, 10000);
+    bench_container("container_horz", ED_HORZ, 100000);
+    bench_container("container_vert", ED_VERT, 10000);
+    bench_container("container_vert", ED_VERT, 100000);
+#endif
+
+    bench_nested(10);
+    bench_nested(40);
+#ifdef ED_HEADLESS
+    // Deeper than the nesting limit of native child windows.
+    bench_nested(400);
+#endif
+
+    check_hide();
+    check_commit();
+    check_reflow();
+    check_list();
+    check_scroll();
+    check_handles();
+    check_grid();
+
+    bench_groups(20);
+    bench_groups(200);
+
+    bench_matrix(16, false);
+    bench_matrix(16, true);
+    bench_matrix(64, false);
+    bench_matrix(64, true);
+
+    bench_vector(16, false);
+    bench_vector(16, true);
+    bench_vector(256, false);
+    bench_vector(256, true);
+
+    bench_windows(8000);
+
+    bench_scroll(1000);
+    bench_scroll(4000);
+
+    bench_list(1000);
+    bench_list(20000);
+
+    bench_tall_scroll(1000, 1100);
+    bench_tall_list(100000);
+
+    bench_label(1000);
+    bench_label(8000);
+
+    bench_sync(2000);
+#ifdef ED_HEADLESS
+    // Each value has an input and a label window.
+    bench_sync(10000);
+#endif
+    bench_sync_version(16);
+    bench_sync_version(2000);
+
+    bench_notify(2000);
+#ifdef ED_HEADLESS
+    bench_notify(10000);
+#endif
+
+    bench_text(300);
+    bench_text(2000);
+
+    bench_update_budget(100, 8);
+
+    bench_compact(4000);
+    bench_compact(8000);
+
+    bench_remove_subtree(2000);
+    bench_remove_subtree(8000);
+    bench_remove_rows(2000);
+    bench_remove_rows(8000);
+
+    ed_deinit();
+    DestroyWindow(hwnd);
+    return failed_checks ? 1 : 0;
+}
@@ -0,0 +1,20 @@
+// Window subclassing from comctl32, see windows.h.
+#ifndef ED_HEADLESS_COMMCTRL_H
+#define ED_HEADLESS_COMMCTRL_H
+
+#include <windows.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef LRESULT (*SUBCLASSPROC)(HWND, UINT, WPARAM, LPARAM, UINT_PTR, DWORD_PTR);
+
+BOOL SetWindowSubclass(HWND hwnd, SUBCLASSPROC proc, UINT_PTR id, DWORD_PTR data);
+LRESULT DefSubclassProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,850 @@
+// Headless implementation of the Win32 subset in windows.h and commctrl.h.
+// Windows form a tree of structs and messages are dispatched synchronously to
+// the subclass chain and the class window proc, which is all edwin needs to
+// build, measure and lay out a tree. Nothing is drawn.
+#define _GNU_SOURCE
+#include <windows.h>
+#include <commctrl.h>
+
+#include <assert.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define HL_MAX_CLASSES 64
+#define HL_MAX_SUBCLASSES 8
+#define HL_MAX_EXTRA 4
+#define HL_MAX_DISPATCH_DEPTH 256
+
+struct hl_class {
+    char name[32];
+    WNDPROC proc;
+};
+
+struct hl_subclass {
+    SUBCLASSPROC proc;
+    UINT_PTR id;
+    DWORD_PTR data;
+};
+
+struct HWND__ {
+    char class_name[32];
+    WNDPROC proc;
+    char *text;
+    DWORD style;
+    LONG_PTR user_data;
+    LONG_PTR id;
+    LONG_PTR extra[HL_MAX_EXTRA];
+    int x, y, w, h;         // Relative to the parent window
+    HWND parent, child;     // First child
+    HWND last_child;        // Last child, new children are appended after it
+    HWND before, after;     // Siblings
+    struct hl_subclass subclasses[HL_MAX_SUBCLASSES];
+    int subclass_count;
+    SCROLLINFO scroll;
+};
+
+// Position in the subclass chain of each message being dispatched, so
+// DefSubclassProc knows which proc to call next.
+struct hl_dispatch {
+    HWND hwnd;
+    int subclass;
+};
+
+static struct hl_class hl_classes[HL_MAX_CLASSES];
+static int hl_class_count;
+static HWND hl_focus;
+
+static _Thread_local struct hl_dispatch hl_dispatch_stack[HL_MAX_DISPATCH_DEPTH];
+static _Thread_local int hl_dispatch_depth;
+
+static char *
+hl_strdup(const char *s)
+{
+    size_t len = s ? strlen(s) : 0;
+    char *copy = (char *)malloc(len + 1);
+    assert(copy && "out of memory.");
+    if (len) memcpy(copy, s, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+static void
+hl_link(HWND hwnd, HWND parent)
+{
+    hwnd->parent = parent;
+    hwnd->before = NULL;
+    hwnd->after = NULL;
+    if (!parent) return;
+
+    // Appended last, like the z-order of a new child window.
+    HWND last = parent->last_child;
+    parent->last_child = hwnd;
+    if (!last) {
+        parent->child = hwnd;
+        return;
+    }
+    last->after = hwnd;
+    hwnd->before = last;
+}
+
+static void
+hl_unlink(HWND hwnd)
+{
+    if (hwnd->before) {
+        hwnd->before->after = hwnd->after;
+    } else if (hwnd->parent) {
+        hwnd->parent->child = hwnd->after;
+    }
+    if (hwnd->after) {
+        hwnd->after->before = hwnd->before;
+    } else if (hwnd->parent) {
+        hwnd->parent->last_child = hwnd->before;
+    }
+    hwnd->parent = NULL;
+    hwnd->before = NULL;
+    hwnd->after = NULL;
+}
+
+static void
+hl_origin(HWND hwnd, int *x, int *y)
+{
+    *x = 0;
+    *y = 0;
+    for (HWND w = hwnd; w; w = w->parent) {
+        *x += w->x;
+        *y += w->y;
+    }
+}
+
+ATOM
+RegisterClassA(const WNDCLASSA *wnd_class)
+{
+    for (int i = 0; i < hl_class_count; ++i) {
+        if (strcmp(hl_classes[i].name, wnd_class->lpszClassName) == 0) return 0;
+    }
+    assert(hl_class_count < HL_MAX_CLASSES && "too many window classes.");
+
+    struct hl_class *c = &hl_classes[hl_class_count++];
+    strncpy(c->name, wnd_class->lpszClassName, sizeof c->name - 1);
+    c->proc = wnd_class->lpfnWndProc;
+    return (ATOM)hl_class_count;
+}
+
+HWND
+CreateWindowA(LPCSTR class_name, LPCSTR name, DWORD style, int x, int y, int w, int h,
+        HWND parent, HMENU menu, HINSTANCE instance, void *param)
+{
+    (void)instance;
+    (void)param;
+
+    HWND hwnd = (HWND)calloc(1, sizeof(struct HWND__));
+    assert(hwnd && "out of memory.");
+    strncpy(hwnd->class_name, class_name, sizeof hwnd->class_name - 1);
+
+    // Predefined controls only need the default text handling.
+    hwnd->proc = DefWindowProcA;
+    for (int i = 0; i < hl_class_count; ++i) {
+        if (strcmp(hl_classes[i].name, class_name) == 0) {
+            hwnd->proc = hl_classes[i].proc;
+            break;
+        }
+    }
+
+    hwnd->text = hl_strdup(name);
+    hwnd->style = style;
+    hwnd->id = (LONG_PTR)menu;
+    hwnd->x = x;
+    hwnd->y = y;
+    hwnd->w = w;
+    hwnd->h = h;
+    hl_link(hwnd, parent);
+    return hwnd;
+}
+
+BOOL
+DestroyWindow(HWND hwnd)
+{
+    if (!hwnd) return FALSE;
+
+    SendMessageA(hwnd, WM_DESTROY, 0, 0);
+    while (hwnd->child) {
+        DestroyWindow(hwnd->child);
+    }
+
+    if (hl_focus == hwnd) hl_focus = NULL;
+    hl_unlink(hwnd);
+    free(hwnd->text);
+    free(hwnd);
+    return TRUE;
+}
+
+LRESULT
+DefWindowProcA(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
+{
+    switch (msg) {
+    case WM_SETTEXT:
+        free(hwnd->text);
+        hwnd->text = hl_strdup((const char *)lparam);
+        return TRUE;
+    case WM_GETTEXT: {
+        size_t size = (size_t)wparam;
+        if (!size) return 0;
+        size_t len = strlen(hwnd->text);
+        if (len > size - 1) len = size - 1;
+        memcpy((char *)lparam, hwnd->text, len);
+        ((char *)lparam)[len] = '\0';
+        return (LRESULT)len;
+    }
+    case WM_GETTEXTLENGTH:
+        return (LRESULT)strlen(hwnd->text);
+    }
+    return 0;
+}
+
+LRESULT
+SendMessageA(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
+{
+    if (!hwnd) return 0;
+    assert(hl_dispatch_depth < HL_MAX_DISPATCH_DEPTH && "messages nested too deep.");
+
+    // The subclass added last is called first.
+    struct hl_dispatch *d = &hl_dispatch_stack[hl_dispatch_depth++];
+    d->hwnd = hwnd;
+    d->subclass = hwnd->subclass_count;
+    LRESULT result = DefSubclassProc(hwnd, msg, wparam, lparam);
+    --hl_dispatch_depth;
+    return result;
+}
+
+BOOL
+SetWindowSubclass(HWND hwnd, SUBCLASSPROC proc, UINT_PTR id, DWORD_PTR data)
+{
+    for (int i = 0; i < hwnd->subclass_count; ++i) {
+        struct hl_subclass *s = &hwnd->subclasses[i];
+        if (s->proc == proc && s->id == id) {
+            s->data = data;
+            return TRUE;
+        }
+    }
+
+    assert(hwnd->subclass_count < HL_MAX_SUBCLASSES && "too many subclasses.");
+    struct hl_subclass *s = &hwnd->subclasses[hwnd->subclass_count++];
+    s->proc = proc;
+    s->id = id;
+    s->data = data;
+    return TRUE;
+}
+
+LRESULT
+DefSubclassProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
+{
+    struct hl_dispatch *d = hl_dispatch_depth
+        ? &hl_dispatch_stack[hl_dispatch_depth - 1] : NULL;
+
+    if (!d || d->hwnd != hwnd || d->subclass == 0) {
+        return hwnd->proc(hwnd, msg, wparam, lparam);
+    }
+
+    struct hl_subclass *s = &hwnd->subclasses[--d->subclass];
+    return s->proc(hwnd, msg, wparam, lparam, s->id, s->data);
+}
+
+int
+GetClassNameA(HWND hwnd, LPSTR name, int size)
+{
+    if (size <= 0) return 0;
+    strncpy(name, hwnd->class_name, (size_t)size - 1);
+    name[size - 1] = '\0';
+    return (int)strlen(name);
+}
+
+LONG
+GetWindowLongA(HWND hwnd, int index)
+{
+    return (LONG)GetWindowLongPtrA(hwnd, index);
+}
+
+LONG_PTR
+GetWindowLongPtrA(HWND hwnd, int index)
+{
+    switch (index) {
+    case GWLP_USERDATA: return hwnd->user_data;
+    case GWLP_ID: return hwnd->id;
+    case GWL_STYLE: return (LONG_PTR)hwnd->style;
+    }
+    assert(index >= 0 && index / (int)sizeof(LONG_PTR) < HL_MAX_EXTRA);
+    return hwnd->extra[index / sizeof(LONG_PTR)];
+}
+
+LONG_PTR
+SetWindowLongPtrA(HWND hwnd, int index, LONG_PTR value)
+{
+    LONG_PTR old = GetWindowLongPtrA(hwnd, index);
+    switch (index) {
+    case GWLP_USERDATA: hwnd->user_data = value; break;
+    case GWLP_ID: hwnd->id = value; break;
+    case GWL_STYLE: hwnd->style = (DWORD)value; break;
+    default: hwnd->extra[index / sizeof(LONG_PTR)] = value; break;
+    }
+    return old;
+}
+
+HWND
+SetParent(HWND hwnd, HWND parent)
+{
+    HWND old = hwnd->parent;
+    hl_unlink(hwnd);
+    hl_link(hwnd, parent);
+    return old;
+}
+
+BOOL
+SetWindowTextA(HWND hwnd, LPCSTR text)
+{
+    return (BOOL)SendMessageA(hwnd, WM_SETTEXT, 0, (LPARAM)text);
+}
+
+int
+GetWindowTextA(HWND hwnd, LPSTR text, int size)
+{
+    return (int)SendMessageA(hwnd, WM_GETTEXT, (WPARAM)size, (LPARAM)text);
+}
+
+int
+GetWindowTextLengthA(HWND hwnd)
+{
+    return (int)SendMessageA(hwnd, WM_GETTEXTLENGTH, 0, 0);
+}
+
+BOOL
+ShowWindow(HWND hwnd, int cmd)
+{
+    BOOL was_visible = (hwnd->style & WS_VISIBLE) != 0;
+    if (cmd == SW_HIDE) {
+        hwnd->style &= ~WS_VISIBLE;
+    } else {
+        hwnd->style |= WS_VISIBLE;
+    }
+    return was_visible;
+}
+
+BOOL
+IsWindowVisible(HWND hwnd)
+{
+    for (HWND w = hwnd; w; w = w->parent) {
+        if (!(w->style & WS_VISIBLE)) return FALSE;
+    }
+    return hwnd != NULL;
+}
+
+BOOL
+EnableWindow(HWND hwnd, BOOL enable)
+{
+    BOOL was_disabled = (hwnd->style & WS_DISABLED) != 0;
+    if (enable) {
+        hwnd->style &= ~WS_DISABLED;
+    } else {
+        hwnd->style |= WS_DISABLED;
+    }
+    return was_disabled;
+}
+
+BOOL
+IsWindowEnabled(HWND hwnd)
+{
+    return !(hwnd->style & WS_DISABLED);
+}
+
+BOOL
+SetWindowPos(HWND hwnd, HWND after, int x, int y, int w, int h, UINT flags)
+{
+    (void)after;
+    if (!(flags & SWP_NOMOVE)) {
+        hwnd->x = x;
+        hwnd->y = y;
+    }
+    if (!(flags & SWP_NOSIZE)) {
+        hwnd->w = w;
+        hwnd->h = h;
+    }
+    if (flags & SWP_SHOWWINDOW) hwnd->style |= WS_VISIBLE;
+    if (flags & SWP_HIDEWINDOW) hwnd->style &= ~WS_VISIBLE;
+    return TRUE;
+}
+
+// Positions are applied as they are deferred, nothing is drawn in between.
+HDWP
+BeginDeferWindowPos(int count)
+{
+    (void)count;
+    static char batch;
+    return (HDWP)&batch;
+}
+
+HDWP
+DeferWindowPos(HDWP hdwp, HWND hwnd, HWND after, int x, int y, int w, int h, UINT flags)
+{
+    SetWindowPos(hwnd, after, x, y, w, h, flags);
+    return hdwp;
+}
+
+BOOL
+EndDeferWindowPos(HDWP hdwp)
+{
+    (void)hdwp;
+    return TRUE;
+}
+
+BOOL
+GetWindowRect(HWND hwnd, RECT *rect)
+{
+    int x, y;
+    hl_origin(hwnd, &x, &y);
+    rect->left = x;
+    rect->top = y;
+    rect->right = x + hwnd->w;
+    rect->bottom = y + hwnd->h;
+    return TRUE;
+}
+
+BOOL
+GetClientRect(HWND hwnd, RECT *rect)
+{
+    rect->left = 0;
+    rect->top = 0;
+    rect->right = hwnd->w;
+    rect->bottom = hwnd->h;
+    return TRUE;
+}
+
+BOOL
+AdjustWindowRect(RECT *rect, DWORD style, BOOL menu)
+{
+    (void)rect;
+    (void)style;
+    (void)menu;
+    return TRUE;
+}
+
+int
+MapWindowPoints(HWND from, HWND to, POINT *points, UINT count)
+{
+    int fx = 0, fy = 0, tx = 0, ty = 0;
+    if (from) hl_origin(from, &fx, &fy);
+    if (to) hl_origin(to, &tx, &ty);
+    for (UINT i = 0; i < count; ++i) {
+        points[i].x += fx - tx;
+        points[i].y += fy - ty;
+    }
+    return ((fx - tx) & 0xffff) | ((fy - ty) << 16);
+}
+
+// Scrolling the whole client area moves the child windows with it.
+BOOL
+ScrollWindow(HWND hwnd, int dx, int dy, const RECT *rect, const RECT *clip)
+{
+    if (rect || clip) return TRUE;
+    for (HWND c = hwnd->child; c; c = c->after) {
+        c->x += dx;
+        c->y += dy;
+    }
+    return TRUE;
+}
+
+BOOL
+InvalidateRect(HWND hwnd, const RECT *rect, BOOL erase)
+{
+    (void)hwnd;
+    (void)rect;
+    (void)erase;
+    return TRUE;
+}
+
+BOOL
+RedrawWindow(HWND hwnd, const RECT *rect, HRGN rgn, UINT flags)
+{
+    (void)hwnd;
+    (void)rect;
+    (void)rgn;
+    (void)flags;
+    return TRUE;
+}
+
+static int
+hl_clamp_scroll(const SCROLLINFO *si, int pos)
+{
+    int page = si->nPage ? (int)si->nPage - 1 : 0;
+    int max = si->nMax - page;
+    if (pos > max) pos = max;
+    if (pos < si->nMin) pos = si->nMin;
+    return pos;
+}
+
+int
+SetScrollInfo(HWND hwnd, int bar, const SCROLLINFO *si, BOOL redraw)
+{
+    (void)bar;
+    (void)redraw;
+    if (si->fMask & SIF_RANGE) {
+        hwnd->scroll.nMin = si->nMin;
+        hwnd->scroll.nMax = si->nMax;
+    }
+    if (si->fMask & SIF_PAGE) hwnd->scroll.nPage = si->nPage;
+    if (si->fMask & SIF_POS) hwnd->scroll.nPos = si->nPos;
+    hwnd->scroll.nPos = hl_clamp_scroll(&hwnd->scroll, hwnd->scroll.nPos);
+    hwnd->scroll.nTrackPos = hwnd->scroll.nPos;
+    return hwnd->scroll.nPos;
+}
+
+int
+GetScrollInfo(HWND hwnd, int bar, SCROLLINFO *si)
+{
+    (void)bar;
+    if (si->fMask & SIF_RANGE) {
+        si->nMin = hwnd->scroll.nMin;
+        si->nMax = hwnd->scroll.nMax;
+    }
+    if (si->fMask & SIF_PAGE) si->nPage = hwnd->scroll.nPage;
+    if (si->fMask & SIF_POS) si->nPos = hwnd->scroll.nPos;
+    if (si->fMask & SIF_TRACKPOS) si->nTrackPos = hwnd->scroll.nTrackPos;
+    return TRUE;
+}
+
+int
+SetScrollPos(HWND hwnd, int bar, int pos, BOOL redraw)
+{
+    (void)bar;
+    (void)redraw;
+    int old = hwnd->scroll.nPos;
+    hwnd->scroll.nPos = hl_clamp_scroll(&hwnd->scroll, pos);
+    hwnd->scroll.nTrackPos = hwnd->scroll.nPos;
+    return old;
+}
+
+int
+GetScrollPos(HWND hwnd, int bar)
+{
+    (void)bar;
+    return hwnd->scroll.nPos;
+}
+
+HWND
+SetFocus(HWND hwnd)
+{
+    HWND old = hl_focus;
+    hl_focus = hwnd;
+    return old;
+}
+
+HWND
+GetFocus(void)
+{
+    return hl_focus;
+}
+
+HWND
+SetCapture(HWND hwnd)
+{
+    (void)hwnd;
+    return NULL;
+}
+
+short
+GetKeyState(int key)
+{
+    (void)key;
+    return 0;
+}
+
+BOOL
+GetCursorPos(POINT *point)
+{
+    point->x = 0;
+    point->y = 0;
+    return TRUE;
+}
+
+HCURSOR
+SetCursor(HCURSOR cursor)
+{
+    (void)cursor;
+    return NULL;
+}
+
+HCURSOR
+LoadCursorA(HINSTANCE instance, LPCSTR name)
+{
+    (void)instance;
+    (void)name;
+    return NULL;
+}
+
+BOOL
+HideCaret(HWND hwnd)
+{
+    (void)hwnd;
+    return TRUE;
+}
+
+BOOL
+ShowCaret(HWND hwnd)
+{
+    (void)hwnd;
+    return TRUE;
+}
+
+HMODULE
+GetModuleHandleA(LPCSTR name)
+{
+    (void)name;
+    static char module;
+    return (HMODULE)&module;
+}
+
+int
+GetSystemMetrics(int index)
+{
+    switch (index) {
+    case SM_CXSCREEN: return 1920;
+    case SM_CYSCREEN: return 1080;
+    case SM_CXVSCROLL: return 17;
+    }
+    return 0;
+}
+
+BOOL
+SystemParametersInfoA(UINT action, UINT param, void *value, UINT flags)
+{
+    (void)flags;
+    switch (action) {
+    case SPI_GETWHEELSCROLLLINES:
+        *(UINT *)value = 3;
+        return TRUE;
+    case SPI_GETNONCLIENTMETRICS:
+        memset(value, 0, param);
+        ((NONCLIENTMETRICS *)value)->cbSize = param;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+DWORD
+GetSysColor(int index)
+{
+    (void)index;
+    return 0;
+}
+
+// GDI objects only keep what GetObject reads back.
+struct hl_gdi_object {
+    BITMAP bitmap;
+};
+
+static char hl_dc;
+static struct hl_gdi_object hl_stock_object;
+
+static HGDIOBJ
+hl_gdi_alloc(int w, int h, void **bits)
+{
+    struct hl_gdi_object *obj =
+        (struct hl_gdi_object *)calloc(1, sizeof(struct hl_gdi_object));
+    assert(obj && "out of memory.");
+    obj->bitmap.bmWidth = w;
+    obj->bitmap.bmHeight = h;
+    obj->bitmap.bmWidthBytes = 4 * w;
+    obj->bitmap.bmPlanes = 1;
+    obj->bitmap.bmBitsPixel = 32;
+    if (bits) {
+        size_t size = (size_t)4 * (size_t)(w < 0 ? -w : w) * (size_t)(h < 0 ? -h : h);
+        obj->bitmap.bmBits = calloc(1, size ? size : 1);
+        assert(obj->bitmap.bmBits && "out of memory.");
+        *bits = obj->bitmap.bmBits;
+    }
+    return obj;
+}
+
+HDC GetDC(HWND hwnd) { (void)hwnd; return (HDC)&hl_dc; }
+int ReleaseDC(HWND hwnd, HDC hdc) { (void)hwnd; (void)hdc; return 1; }
+HDC CreateCompatibleDC(HDC hdc) { (void)hdc; return (HDC)&hl_dc; }
+BOOL DeleteDC(HDC hdc) { (void)hdc; return TRUE; }
+
+HDC
+BeginPaint(HWND hwnd, PAINTSTRUCT *ps)
+{
+    memset(ps, 0, sizeof *ps);
+    ps->hdc = (HDC)&hl_dc;
+    GetClientRect(hwnd, &ps->rcPaint);
+    return ps->hdc;
+}
+
+BOOL EndPaint(HWND hwnd, const PAINTSTRUCT *ps) { (void)hwnd; (void)ps; return TRUE; }
+
+HBITMAP
+CreateCompatibleBitmap(HDC hdc, int w, int h)
+{
+    (void)hdc;
+    return (HBITMAP)hl_gdi_alloc(w, h, NULL);
+}
+
+HBITMAP
+CreateDIBSection(HDC hdc, const BITMAPINFO *info, UINT usage, void **bits, HANDLE section, DWORD offset)
+{
+    (void)hdc;
+    (void)usage;
+    (void)section;
+    (void)offset;
+    return (HBITMAP)hl_gdi_alloc(info->bmiHeader.biWidth, info->bmiHeader.biHeight, bits);
+}
+
+HFONT CreateFontIndirectA(const LOGFONTA *font) { (void)font; return (HFONT)hl_gdi_alloc(0, 0, NULL); }
+HPEN CreatePen(int style, int width, COLORREF color) { (void)style; (void)width; (void)color; return (HPEN)hl_gdi_alloc(0, 0, NULL); }
+HRGN CreateRectRgn(int l, int t, int r, int b) { (void)l; (void)t; (void)r; (void)b; return (HRGN)hl_gdi_alloc(0, 0, NULL); }
+HBRUSH CreateSolidBrush(COLORREF color) { (void)color; return (HBRUSH)hl_gdi_alloc(0, 0, NULL); }
+HGDIOBJ GetStockObject(int index) { (void)index; return &hl_stock_object; }
+HGDIOBJ SelectObject(HDC hdc, HGDIOBJ obj) { (void)hdc; (void)obj; return &hl_stock_object; }
+
+BOOL
+DeleteObject(HGDIOBJ obj)
+{
+    if (!obj || obj == &hl_stock_object) return FALSE;
+    struct hl_gdi_object *o = (struct hl_gdi_object *)obj;
+    free(o->bitmap.bmBits);
+    free(o);
+    return TRUE;
+}
+
+int
+GetObjectA(HANDLE obj, int size, void *out)
+{
+    if (!obj || size < (int)sizeof(BITMAP)) return 0;
+    memcpy(out, &((struct hl_gdi_object *)obj)->bitmap, sizeof(BITMAP));
+    return (int)sizeof(BITMAP);
+}
+
+HANDLE
+LoadImageA(HINSTANCE instance, LPCSTR name, UINT type, int w, int h, UINT flags)
+{
+    (void)instance;
+    (void)name;
+    (void)type;
+    (void)w;
+    (void)h;
+    (void)flags;
+    return NULL;
+}
+
+BOOL GetIconInfo(HICON icon, ICONINFO *info) { (void)icon; memset(info, 0, sizeof *info); return FALSE; }
+BOOL DestroyIcon(HICON icon) { (void)icon; return TRUE; }
+
+// Metrics of a 9pt proportional UI font: narrow, average and wide glyphs.
+BOOL
+GetCharWidth32A(HDC hdc, UINT first, UINT last, int *widths)
+{
+    (void)hdc;
+    for (UINT c = first; c <= last; ++c) {
+        int w = 7;
+        if (c < 32) w = 0;
+        else if (strchr(" .,:;'!|iljtf()[]", (int)c)) w = 3;
+        else if (strchr("MWmw@%", (int)c)) w = 11;
+        widths[c - first] = w;
+    }
+    return TRUE;
+}
+
+BOOL
+GetTextMetricsA(HDC hdc, TEXTMETRICA *tm)
+{
+    (void)hdc;
+    memset(tm, 0, sizeof *tm);
+    tm->tmHeight = 15;
+    tm->tmAscent = 12;
+    tm->tmDescent = 3;
+    tm->tmAveCharWidth = 7;
+    tm->tmMaxCharWidth = 11;
+    return TRUE;
+}
+
+int SelectClipRgn(HDC hdc, HRGN rgn) { (void)hdc; (void)rgn; return 1; }
+COLORREF SetBkColor(HDC hdc, COLORREF color) { (void)hdc; (void)color; return 0; }
+int SetBkMode(HDC hdc, int mode) { (void)hdc; (void)mode; return 1; }
+COLORREF SetTextColor(HDC hdc, COLORREF color) { (void)hdc; (void)color; return 0; }
+int FillRect(HDC hdc, const RECT *rect, HBRUSH brush) { (void)hdc; (void)rect; (void)brush; return 1; }
+int FrameRect(HDC hdc, const RECT *rect, HBRUSH brush) { (void)hdc; (void)rect; (void)brush; return 1; }
+
+BOOL
+InflateRect(RECT *rect, int dx, int dy)
+{
+    rect->left -= dx;
+    rect->top -= dy;
+    rect->right += dx;
+    rect->bottom += dy;
+    return TRUE;
+}
+
+int DrawTextA(HDC hdc, LPCSTR text, int len, RECT *rect, UINT format) { (void)hdc; (void)text; (void)len; (void)rect; (void)format; return 0; }
+BOOL DrawEdge(HDC hdc, RECT *rect, UINT edge, UINT flags) { (void)hdc; (void)rect; (void)edge; (void)flags; return TRUE; }
+BOOL DrawFrameControl(HDC hdc, RECT *rect, UINT type, UINT state) { (void)hdc; (void)rect; (void)type; (void)state; return TRUE; }
+BOOL Ellipse(HDC hdc, int l, int t, int r, int b) { (void)hdc; (void)l; (void)t; (void)r; (void)b; return TRUE; }
+BOOL PolyPolygon(HDC hdc, const POINT *points, const INT *counts, int count) { (void)hdc; (void)points; (void)counts; (void)count; return TRUE; }
+
+BOOL
+BitBlt(HDC dst, int x, int y, int w, int h, HDC src, int sx, int sy, DWORD rop)
+{
+    (void)dst; (void)x; (void)y; (void)w; (void)h; (void)src; (void)sx; (void)sy; (void)rop;
+    return TRUE;
+}
+
+BOOL
+StretchBlt(HDC dst, int x, int y, int w, int h, HDC src, int sx, int sy, int sw, int sh, DWORD rop)
+{
+    (void)dst; (void)x; (void)y; (void)w; (void)h; (void)src; (void)sx; (void)sy;
+    (void)sw; (void)sh; (void)rop;
+    return TRUE;
+}
+
+BOOL
+AlphaBlend(HDC dst, int x, int y, int w, int h, HDC src, int sx, int sy, int sw, int sh, BLENDFUNCTION blend)
+{
+    (void)dst; (void)x; (void)y; (void)w; (void)h; (void)src; (void)sx; (void)sy;
+    (void)sw; (void)sh; (void)blend;
+    return TRUE;
+}
+
+// The once word is 0 before, 1 while and 2 after the function ran. Callers
+// that lose the race wait until the winner is done, and retry if it failed.
+BOOL
+InitOnceExecuteOnce(INIT_ONCE *once, PINIT_ONCE_FN fn, void *param, void **context)
+{
+    for (;;) {
+        void *expected = NULL;
+        if (__atomic_compare_exchange_n(&once->Ptr, &expected, (void *)1, false,
+                    __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+            BOOL result = fn(once, param, context);
+            __atomic_store_n(&once->Ptr, result ? (void *)2 : NULL, __ATOMIC_RELEASE);
+            return result;
+        }
+        if (expected == (void *)2) {
+            return TRUE;
+        }
+        sched_yield();
+    }
+}
+
+BOOL
+QueryPerformanceCounter(LARGE_INTEGER *ticks)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ticks->QuadPart = (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    return TRUE;
+}
+
+BOOL
+QueryPerformanceFrequency(LARGE_INTEGER *freq)
+{
+    freq->QuadPart = 1000000000LL;
+    return TRUE;
+}
@@ -0,0 +1,385 @@
+// Subset of the Win32 API used by edwin.c and bench.c, implemented by
+// win32.c without a window system so the layout benchmarks build and run on
+// Linux. Windows only hold the state edwin reads back: text, style, position,
+// extra bytes, subclasses and scrollbar info. Drawing calls do nothing.
+#ifndef ED_HEADLESS_WINDOWS_H
+#define ED_HEADLESS_WINDOWS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define WINAPI
+#define CALLBACK
+#define __stdcall
+
+typedef int BOOL;
+typedef int INT;
+typedef unsigned int UINT;
+typedef int32_t LONG;
+typedef uint32_t DWORD;
+typedef uint16_t WORD;
+typedef uint8_t BYTE;
+typedef uint16_t ATOM;
+typedef uintptr_t WPARAM;
+typedef intptr_t LPARAM;
+typedef intptr_t LRESULT;
+typedef intptr_t LONG_PTR;
+typedef uintptr_t UINT_PTR;
+typedef uintptr_t DWORD_PTR;
+typedef DWORD COLORREF;
+typedef const char *LPCSTR;
+typedef char *LPSTR;
+typedef void *HANDLE;
+typedef void *HGDIOBJ;
+
+typedef struct HWND__ *HWND;
+typedef struct HDC__ *HDC;
+typedef struct HBRUSH__ *HBRUSH;
+typedef struct HFONT__ *HFONT;
+typedef struct HBITMAP__ *HBITMAP;
+typedef struct HICON__ *HICON;
+typedef struct HMENU__ *HMENU;
+typedef struct HPEN__ *HPEN;
+typedef struct HRGN__ *HRGN;
+typedef struct HINSTANCE__ *HINSTANCE;
+typedef struct HCURSOR__ *HCURSOR;
+typedef struct HDWP__ *HDWP;
+typedef HINSTANCE HMODULE;
+
+typedef LRESULT (*WNDPROC)(HWND, UINT, WPARAM, LPARAM);
+
+typedef union {
+    struct { DWORD LowPart; LONG HighPart; } u;
+    long long QuadPart;
+} LARGE_INTEGER;
+
+typedef struct { LONG left, top, right, bottom; } RECT;
+typedef struct { LONG x, y; } POINT, *LPPOINT;
+typedef struct { LONG cx, cy; } SIZE;
+typedef struct { HDC hdc; BOOL fErase; RECT rcPaint; } PAINTSTRUCT;
+
+typedef struct {
+    UINT cbSize, fMask;
+    int nMin, nMax;
+    UINT nPage;
+    int nPos, nTrackPos;
+} SCROLLINFO;
+
+typedef struct {
+    UINT style;
+    WNDPROC lpfnWndProc;
+    int cbClsExtra, cbWndExtra;
+    HINSTANCE hInstance;
+    HICON hIcon;
+    HCURSOR hCursor;
+    HBRUSH hbrBackground;
+    LPCSTR lpszMenuName, lpszClassName;
+} WNDCLASSA;
+
+typedef struct {
+    UINT CtlType, CtlID, itemID, itemAction, itemState;
+    HWND hwndItem;
+    HDC hDC;
+    RECT rcItem;
+    uintptr_t itemData;
+} DRAWITEMSTRUCT;
+
+typedef struct {
+    LONG bmType, bmWidth, bmHeight, bmWidthBytes;
+    WORD bmPlanes, bmBitsPixel;
+    void *bmBits;
+} BITMAP;
+
+typedef struct { BOOL fIcon; DWORD xHotspot, yHotspot; HBITMAP hbmMask, hbmColor; } ICONINFO;
+
+typedef struct {
+    DWORD biSize;
+    LONG biWidth, biHeight;
+    WORD biPlanes, biBitCount;
+    DWORD biCompression, biSizeImage;
+    LONG biXPelsPerMeter, biYPelsPerMeter;
+    DWORD biClrUsed, biClrImportant;
+} BITMAPINFOHEADER;
+
+typedef struct { BITMAPINFOHEADER bmiHeader; DWORD bmiColors[1]; } BITMAPINFO;
+typedef struct { BYTE BlendOp, BlendFlags, SourceConstantAlpha, AlphaFormat; } BLENDFUNCTION;
+typedef struct { LONG lfHeight; char lfFaceName[32]; } LOGFONTA;
+typedef struct { UINT cbSize; LOGFONTA lfStatusFont; } NONCLIENTMETRICS;
+
+typedef struct {
+    LONG tmHeight, tmAscent, tmDescent, tmInternalLeading, tmExternalLeading;
+    LONG tmAveCharWidth, tmMaxCharWidth;
+} TEXTMETRICA;
+
+typedef struct { void *Ptr; } INIT_ONCE;
+#define INIT_ONCE_STATIC_INIT {0}
+typedef BOOL (CALLBACK *PINIT_ONCE_FN)(INIT_ONCE *once, void *param, void **context);
+
+#define TRUE 1
+#define FALSE 0
+#define INFINITE 0xffffffffu
+#define ARRAYSIZE(a) (sizeof(a) / sizeof((a)[0]))
+#define LOWORD(l) ((WORD)((DWORD_PTR)(l) & 0xffff))
+#define HIWORD(l) ((WORD)(((DWORD_PTR)(l) >> 16) & 0xffff))
+#define MAKEWPARAM(l, h) ((WPARAM)(DWORD)(((WORD)(l)) | ((DWORD)((WORD)(h))) << 16))
+#define GET_WHEEL_DELTA_WPARAM(w) ((short)HIWORD(w))
+#define RGB(r, g, b) ((COLORREF)((BYTE)(r) | ((WORD)((BYTE)(g)) << 8) | ((DWORD)(BYTE)(b) << 16)))
+#define WHEEL_DELTA 120
+#define IDC_ARROW ((LPCSTR)32512)
+#define HWND_DESKTOP ((HWND)0)
+
+#define _malloca(size) malloc(size)
+#define _freea(p) free(p)
+
+// Messages
+#define WM_DESTROY     0x0002
+#define WM_SIZE        0x0005
+#define WM_SETFOCUS    0x0007
+#define WM_KILLFOCUS   0x0008
+#define WM_SETREDRAW   0x000B
+#define WM_SETTEXT     0x000C
+#define WM_GETTEXT     0x000D
+#define WM_GETTEXTLENGTH 0x000E
+#define WM_PAINT       0x000F
+#define WM_CLOSE       0x0010
+#define WM_QUIT        0x0012
+#define WM_SETCURSOR   0x0020
+#define WM_DRAWITEM    0x002B
+#define WM_SETFONT     0x0030
+#define WM_NCHITTEST   0x0084
+#define WM_KEYDOWN     0x0100
+#define WM_KEYUP       0x0101
+#define WM_CHAR        0x0102
+#define WM_COMMAND     0x0111
+#define WM_VSCROLL     0x0115
+#define WM_MOUSEMOVE   0x0200
+#define WM_LBUTTONDOWN 0x0201
+#define WM_LBUTTONUP   0x0202
+#define WM_RBUTTONUP   0x0205
+#define WM_MOUSEWHEEL  0x020A
+#define WM_APP         0x8000
+
+// Window styles
+#define WS_OVERLAPPED 0x00000000L
+#define WS_CHILD      0x40000000L
+#define WS_VISIBLE    0x10000000L
+#define WS_DISABLED   0x08000000L
+#define WS_CAPTION    0x00C00000L
+#define WS_BORDER     0x00800000L
+#define WS_VSCROLL    0x00200000L
+#define WS_SYSMENU    0x00080000L
+#define WS_OVERLAPPEDWINDOW 0x00CF0000L
+
+// Control styles
+#define SS_ICON        0x0003L
+#define SS_BITMAP      0x000EL
+#define SS_ETCHEDHORZ  0x0010L
+#define SS_ETCHEDVERT  0x0011L
+#define SS_CENTERIMAGE 0x0200L
+#define ES_MULTILINE   0x0004L
+#define ES_AUTOVSCROLL 0x0040L
+#define ES_AUTOHSCROLL 0x0080L
+#define ES_WANTRETURN  0x1000L
+#define BS_PUSHBUTTON  0x0000L
+#define BS_3STATE      0x0005L
+#define BS_ICON        0x0040L
+#define BS_BITMAP      0x0080L
+#define CBS_DROPDOWNLIST   0x0003L
+#define CBS_OWNERDRAWFIXED 0x0010L
+#define SBS_VERT       0x0001L
+
+// Control messages and notifications
+#define BM_GETCHECK    0x00F0
+#define BM_SETCHECK    0x00F1
+#define BM_CLICK       0x00F5
+#define BM_SETIMAGE    0x00F7
+#define BN_CLICKED     0
+#define BST_CHECKED    0x0001
+#define BST_INDETERMINATE 0x0002
+#define CB_ADDSTRING   0x0143
+#define CB_GETCURSEL   0x0147
+#define CB_SETCURSEL   0x014E
+#define CB_SHOWDROPDOWN 0x014F
+#define CB_GETITEMDATA 0x0150
+#define CBN_SELCHANGE  1
+#define EM_SETSEL      0x00B1
+#define EM_SETREADONLY 0x00CF
+#define STM_SETIMAGE   0x0172
+#define ODT_COMBOBOX   3
+#define ODS_COMBOBOXEDIT 0x1000
+#define HTTRANSPARENT  (-1)
+
+// Scrollbars
+#define SB_CTL         2
+#define SB_LINEUP      0
+#define SB_LINEDOWN    1
+#define SB_THUMBPOSITION 4
+#define SB_THUMBTRACK  5
+#define SIF_RANGE      0x0001
+#define SIF_PAGE       0x0002
+#define SIF_POS        0x0004
+#define SIF_TRACKPOS   0x0010
+#define SIF_ALL        (SIF_RANGE | SIF_PAGE | SIF_POS | SIF_TRACKPOS)
+
+// Window positions
+#define SWP_NOSIZE     0x0001
+#define SWP_NOMOVE     0x0002
+#define SWP_NOZORDER   0x0004
+#define SWP_NOREDRAW   0x0008
+#define SWP_NOACTIVATE 0x0010
+#define SWP_SHOWWINDOW 0x0040
+#define SWP_HIDEWINDOW 0x0080
+#define SWP_NOOWNERZORDER 0x0200
+#define SW_HIDE        0
+#define SW_SHOW        5
+#define RDW_INVALIDATE 0x0001
+#define RDW_ERASE      0x0004
+#define RDW_ALLCHILDREN 0x0080
+
+#define GWLP_USERDATA  (-21)
+#define GWLP_ID        (-12)
+#define GWL_STYLE      (-16)
+
+// System metrics and parameters
+#define SM_CXSCREEN    0
+#define SM_CYSCREEN    1
+#define SM_CXVSCROLL   2
+#define SPI_GETWHEELSCROLLLINES 0x0068
+#define SPI_GETNONCLIENTMETRICS 0x0029
+
+// Keys
+#define VK_LBUTTON     0x01
+#define VK_TAB         0x09
+#define VK_RETURN      0x0D
+#define VK_SHIFT       0x10
+#define VK_ESCAPE      0x1B
+#define VK_SPACE       0x20
+
+// GDI
+#define COLOR_3DFACE   15
+#define COLOR_BTNTEXT  18
+#define COLOR_GRAYTEXT 17
+#define COLOR_HIGHLIGHT 13
+#define COLOR_HIGHLIGHTTEXT 14
+#define COLOR_WINDOW   5
+#define COLOR_WINDOWTEXT 8
+#define NULL_BRUSH     5
+#define PS_SOLID       0
+#define TRANSPARENT    1
+#define SRCCOPY        0x00CC0020
+#define BI_RGB         0
+#define DIB_RGB_COLORS 0
+#define AC_SRC_OVER    0x00
+#define AC_SRC_ALPHA   0x01
+#define IMAGE_BITMAP   0
+#define IMAGE_ICON     1
+#define LR_LOADFROMFILE 0x0010
+#define DT_CENTER      0x0001
+#define DT_VCENTER     0x0004
+#define DT_SINGLELINE  0x0020
+#define DFC_BUTTON     4
+#define DFCS_BUTTONCHECK 0x0000
+#define DFCS_CHECKED   0x0400
+#define BDR_SUNKEN     0x000a
+#define BF_RECT        0x000f
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Windows
+ATOM RegisterClassA(const WNDCLASSA *wnd_class);
+HWND CreateWindowA(LPCSTR class_name, LPCSTR name, DWORD style, int x, int y, int w, int h,
+        HWND parent, HMENU menu, HINSTANCE instance, void *param);
+BOOL DestroyWindow(HWND hwnd);
+LRESULT DefWindowProcA(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam);
+LRESULT SendMessageA(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam);
+int GetClassNameA(HWND hwnd, LPSTR name, int size);
+LONG GetWindowLongA(HWND hwnd, int index);
+LONG_PTR GetWindowLongPtrA(HWND hwnd, int index);
+LONG_PTR SetWindowLongPtrA(HWND hwnd, int index, LONG_PTR value);
+HWND SetParent(HWND hwnd, HWND parent);
+BOOL SetWindowTextA(HWND hwnd, LPCSTR text);
+int GetWindowTextA(HWND hwnd, LPSTR text, int size);
+int GetWindowTextLengthA(HWND hwnd);
+BOOL ShowWindow(HWND hwnd, int cmd);
+BOOL IsWindowVisible(HWND hwnd);
+BOOL EnableWindow(HWND hwnd, BOOL enable);
+BOOL IsWindowEnabled(HWND hwnd);
+BOOL SetWindowPos(HWND hwnd, HWND after, int x, int y, int w, int h, UINT flags);
+HDWP BeginDeferWindowPos(int count);
+HDWP DeferWindowPos(HDWP hdwp, HWND hwnd, HWND after, int x, int y, int w, int h, UINT flags);
+BOOL EndDeferWindowPos(HDWP hdwp);
+BOOL GetWindowRect(HWND hwnd, RECT *rect);
+BOOL GetClientRect(HWND hwnd, RECT *rect);
+BOOL AdjustWindowRect(RECT *rect, DWORD style, BOOL menu);
+int MapWindowPoints(HWND from, HWND to, POINT *points, UINT count);
+BOOL ScrollWindow(HWND hwnd, int dx, int dy, const RECT *rect, const RECT *clip);
+BOOL InvalidateRect(HWND hwnd, const RECT *rect, BOOL erase);
+BOOL RedrawWindow(HWND hwnd, const RECT *rect, HRGN rgn, UINT flags);
+int SetScrollInfo(HWND hwnd, int bar, const SCROLLINFO *si, BOOL redraw);
+int GetScrollInfo(HWND hwnd, int bar, SCROLLINFO *si);
+int SetScrollPos(HWND hwnd, int bar, int pos, BOOL redraw);
+int GetScrollPos(HWND hwnd, int bar);
+HWND SetFocus(HWND hwnd);
+HWND GetFocus(void);
+HWND SetCapture(HWND hwnd);
+short GetKeyState(int key);
+BOOL GetCursorPos(POINT *point);
+HCURSOR SetCursor(HCURSOR cursor);
+HCURSOR LoadCursorA(HINSTANCE instance, LPCSTR name);
+BOOL HideCaret(HWND hwnd);
+BOOL ShowCaret(HWND hwnd);
+HMODULE GetModuleHandleA(LPCSTR name);
+int GetSystemMetrics(int index);
+BOOL SystemParametersInfoA(UINT action, UINT param, void *value, UINT flags);
+DWORD GetSysColor(int index);
+
+// GDI, drawing does nothing
+HDC GetDC(HWND hwnd);
+int ReleaseDC(HWND hwnd, HDC hdc);
+HDC BeginPaint(HWND hwnd, PAINTSTRUCT *ps);
+BOOL EndPaint(HWND hwnd, const PAINTSTRUCT *ps);
+HDC CreateCompatibleDC(HDC hdc);
+BOOL DeleteDC(HDC hdc);
+HBITMAP CreateCompatibleBitmap(HDC hdc, int w, int h);
+HBITMAP CreateDIBSection(HDC hdc, const BITMAPINFO *info, UINT usage, void **bits, HANDLE section, DWORD offset);
+HFONT CreateFontIndirectA(const LOGFONTA *font);
+HPEN CreatePen(int style, int width, COLORREF color);
+HRGN CreateRectRgn(int left, int top, int right, int bottom);
+HBRUSH CreateSolidBrush(COLORREF color);
+HGDIOBJ GetStockObject(int index);
+HGDIOBJ SelectObject(HDC hdc, HGDIOBJ obj);
+BOOL DeleteObject(HGDIOBJ obj);
+int GetObjectA(HANDLE obj, int size, void *out);
+HANDLE LoadImageA(HINSTANCE instance, LPCSTR name, UINT type, int w, int h, UINT flags);
+BOOL GetIconInfo(HICON icon, ICONINFO *info);
+BOOL DestroyIcon(HICON icon);
+BOOL GetCharWidth32A(HDC hdc, UINT first, UINT last, int *widths);
+BOOL GetTextMetricsA(HDC hdc, TEXTMETRICA *tm);
+int SelectClipRgn(HDC hdc, HRGN rgn);
+COLORREF SetBkColor(HDC hdc, COLORREF color);
+int SetBkMode(HDC hdc, int mode);
+COLORREF SetTextColor(HDC hdc, COLORREF color);
+int FillRect(HDC hdc, const RECT *rect, HBRUSH brush);
+int FrameRect(HDC hdc, const RECT *rect, HBRUSH brush);
+BOOL InflateRect(RECT *rect, int dx, int dy);
+int DrawTextA(HDC hdc, LPCSTR text, int len, RECT *rect, UINT format);
+BOOL DrawEdge(HDC hdc, RECT *rect, UINT edge, UINT flags);
+BOOL DrawFrameControl(HDC hdc, RECT *rect, UINT type, UINT state);
+BOOL Ellipse(HDC hdc, int left, int top, int right, int bottom);
+BOOL PolyPolygon(HDC hdc, const POINT *points, const INT *counts, int count);
+BOOL BitBlt(HDC dst, int x, int y, int w, int h, HDC src, int sx, int sy, DWORD rop);
+BOOL StretchBlt(HDC dst, int x, int y, int w, int h, HDC src, int sx, int sy, int sw, int sh, DWORD rop);
+BOOL AlphaBlend(HDC dst, int x, int y, int w, int h, HDC src, int sx, int sy, int sw, int sh, BLENDFUNCTION blend);
+
+// Threads and timing
+BOOL InitOnceExecuteOnce(INIT_ONCE *once, PINIT_ONCE_FN fn, void *param, void **context);
+BOOL QueryPerformanceCounter(LARGE_INTEGER *ticks);
+BOOL QueryPerformanceFrequency(LARGE_INTEGER *freq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
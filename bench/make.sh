@@ -0,0 +1,12 @@
+#!/bin/sh
+# Builds the layout benchmarks without Windows, using the headless window
+# system in bench/headless, and runs them. Arguments are passed to the bench:
+#
+#     bench/make.sh [iterations] [--json]
+set -e
+cd "$(dirname "$0")/.."
+
+${CC:-cc} -O2 -std=c11 -DED_HEADLESS -Ibench/headless -I. \
+    -o bench/bench edwin.c bench/bench.c bench/headless/win32.c -lm
+
+bench/bench "$@"
@@ -10,15 +10,252 @@
 
 #define ED_WM_TABSTOPSETFOCUS (WM_APP + 1)
 
+// Node must be measured again along with its children.
+#define ED_DIRTY_MEASURE 0x1
+// A descendant of the node must be measured again.
+#define ED_DIRTY_CHILD   0x2
+// Children of the node were measured and must be laid out.
+#define ED_DIRTY_LAYOUT  0x4
+// Window geometry of the node is queued for the next commit.
+#define ED_DIRTY_GEOMETRY 0x8
+// Node is queued to be measured on its own, see `ed_mark_dirty`.
+#define ED_DIRTY_REFLOW   0x10
+
+// Axes of a node's dst read by its children during measure.
+#define ED_AXIS_W 0x1
+#define ED_AXIS_H 0x2
+
+// Rows kept alive above and below the viewport of a virtual list.
+#define ED_LIST_MARGIN_ROWS 4
+
+// Largest layout coordinate. Sums of two coordinates still fit in an int, so
+// positions only need to be clamped where sizes are multiplied or accumulated.
+#define ED_COORD_MAX 0x3fffffff
+
+// Native scrollbar positions are limited to 16 bits by the thumb messages,
+// larger scroll extents are mapped onto this range.
+#define ED_SCROLL_NATIVE_MAX 32767
+
+// Offset in the window extra bytes of ED_* classes holding the ed_context
+// owning the window.
+#define ED_WND_CONTEXT 0
+
+#if defined(_MSC_VER) && !defined(__cplusplus)
+#define ED_THREAD_LOCAL __declspec(thread)
+#elif defined(__cplusplus)
+#define ED_THREAD_LOCAL thread_local
+#else
+#define ED_THREAD_LOCAL _Thread_local
+#endif
+
 #define ed_abs(x) (x < 0 ? -(x) : x)
 #define ed_min(a, b) ((a < b) ? (a) : (b))
 #define ed_max(a, b) ((a > b) ? (a) : (b))
 #define ed_clamp(x, a, b) (x < a ? a : (x > b ? b : x))
 
+// Clamps the result of coordinate arithmetic done in 64 bits to the range of
+// layout coordinates.
+static int
+ed_coord(long long v)
+{
+    return (int)ed_clamp(v, -(long long)ED_COORD_MAX, (long long)ED_COORD_MAX);
+}
+
 struct ed_tree_context {
     ed_node *parent;
     ed_node *child;
-    ed_node *removed;
+};
+
+// Nodes are allocated in fixed size chunks which are never moved, so node
+// pointers and ids stay valid for as long as the node is in the tree. A node
+// id maps to a chunk and an offset in that chunk.
+struct ed_node_chunk {
+    ed_node *nodes;    // ED_TREE_CHUNK_SIZE nodes, NULL if the chunk was released
+    ed_node_binding *bindings; // Value data of `nodes`, indexed the same way
+    ed_node *removed;  // Removed nodes in this chunk available for reuse
+    unsigned used;     // Number of nodes handed out since the chunk was allocated
+    unsigned active;   // Number of nodes currently in the tree
+
+    // Nodes released by `ed_release_subtree` which are not yet in `removed`.
+    ed_node *released;
+    ed_node *released_tail;
+    unsigned released_count;
+    struct ed_node_chunk *next_released; // Next chunk with released nodes
+};
+
+struct ed_node_arena {
+    struct ed_node_chunk *chunks;
+    unsigned chunk_count;
+    unsigned chunk_capacity;
+
+    // Lowest chunk index that may have room for a new node.
+    unsigned free_chunk;
+
+    // Number of allocated chunks without any active nodes. One empty chunk is
+    // kept around so rebuilding a panel does not free and allocate a chunk
+    // each time, any other empty chunk is released.
+    unsigned empty_chunks;
+};
+
+// Handles refer to a slot in the handle table, which holds the id of the node
+// and a generation that is incremented each time the node is freed. A slot
+// whose generation reaches ED_HANDLE_GENERATION_MASK is retired instead of
+// reused, so a stale handle never matches a later node. Slot 0 is reserved so
+// a valid handle is never 0.
+struct ed_handle_slot {
+    int id;              // Node id, 0 if the slot is free
+    unsigned generation;
+    unsigned next_free;  // Next free slot when the slot is free
+};
+
+struct ed_handle_table {
+    struct ed_handle_slot *slots;
+    unsigned count;
+    unsigned capacity;
+    unsigned free_slot;
+};
+
+// Open addressing hash table mapping a name within the scope of its nearest
+// named ancestor to a node id.
+struct ed_name_entry {
+    unsigned hash;
+    int scope; // Id of the nearest named ancestor, or ED_ID_ROOT
+    int id;    // Node id, 0 if the entry is empty
+};
+
+struct ed_name_index {
+    struct ed_name_entry *entries;
+    unsigned capacity; // Power of two
+    unsigned count;
+};
+
+// Explicit stack of the nodes being measured, reused by every ed_measure call
+// so the cost of a measure does not depend on the depth of the tree.
+struct ed_measure_frame {
+    ed_node *node;
+    ed_node *child; // Next child to measure
+    bool fit;
+};
+
+struct ed_measure_stack {
+    struct ed_measure_frame *frames;
+    unsigned count;
+    unsigned capacity;
+    unsigned measured_nodes;
+    unsigned cache_lookups;
+    unsigned cache_hits;
+};
+
+// State of a scroll client created by `ed_list`. Only enough row slots to fill
+// the viewport and a margin are created. Slot `s` shows the row `i` in
+// [first, first + slot_count) for which i % slot_count == s, so scrolling by
+// one row binds one slot again.
+struct ed_list {
+    int row_count;
+    int row_height;
+    int scroll;     // Scroll position in pixels
+    int first;      // First row shown by the slots
+    int slot_count;
+    int viewport_h; // Height of the client when the slots were last updated
+    void (*build)(ed_node *row);
+    void (*bind)(ed_node *row, int index);
+};
+
+// Column of a block created by `ed_begin_grid`. Offsets are kept as a part in
+// pixels and a share of the width left after fixed columns and spacing, so a
+// cell is placed without looking at the other columns.
+struct ed_grid_column {
+    int fixed_x;     // Sum of the fixed widths of the columns before
+    float share_x;   // Sum of the shares of the columns before
+    int fixed_w;     // Width in pixels, 0 for a relative column
+    float share_w;   // Share of the remaining width, 0 for a fixed column
+};
+
+// Children of a grid fill it row by row, child `i` is in column
+// i % column_count. Each row is as tall as its tallest cell.
+struct ed_grid {
+    int column_count;
+    int spacing;     // Space between columns and between rows
+    int fixed_w;     // Sum of the fixed column widths
+    struct ed_grid_column *columns;
+
+    // Row reached by the running measure, its y and the height of its cells
+    // measured so far, or -1 for row after a cell was measured on its own.
+    // See `ed_measure_grid_cell`.
+    int row;
+    int row_y;
+    int row_h;
+};
+
+// Advance widths of the single byte characters of a font, so text is measured
+// without a device context. See `ed_load_font_metrics`.
+struct ed_font_metrics {
+    int advance[256];
+    int height;
+};
+
+// List of nodes, such as the nodes whose window geometry was computed by
+// ed_layout, applied through the backend of the context once the outermost
+// ed_layout call returns.
+struct ed_node_queue {
+    ed_node **nodes;
+    unsigned count;
+    unsigned capacity;
+};
+
+// Values bound with ed_bind. Entries are small and contiguous so a sweep of
+// ed_sync only reads the table and the bound values until a value changed.
+struct ed_sync_entry {
+    unsigned long long shadow[2]; // Value displayed by the node, zero padded
+    void *value_ptr;
+    int id;
+    unsigned short size;
+    bool stale;                   // Refresh even if the value matches shadow
+};
+
+// Values bound with ed_bind_version, passed to ed_str_data as a whole when
+// the version counter of the application moves.
+struct ed_sync_block {
+    const unsigned long long *version;
+    unsigned long long seen;      // Version last passed on to ed_str_data
+    void *value_ptr;
+    size_t size;
+    int id;                       // First node of the node_list
+    bool stale;                   // Refresh even if the version did not move
+};
+
+struct ed_sync_table {
+    struct ed_sync_entry *entries;
+    unsigned count;
+    unsigned capacity;
+    struct ed_sync_block *blocks;
+    unsigned block_count;
+    unsigned block_capacity;
+};
+
+// Address range of the value of a node.
+struct ed_range {
+    UINT_PTR begin;
+    UINT_PTR end;
+    int id;
+};
+
+// Ranges of the user values passed to ed_data and ed_bind, so ed_notify_range
+// finds the nodes overlapping a range of memory. Ranges are appended as
+// values are bound and sorted by address on the next query. The sorted array
+// is searched as an implicit binary tree, each range being the root of the
+// subtree between its neighbours, and `max_end` holds the largest end within
+// each subtree.
+struct ed_range_index {
+    struct ed_range *ranges;
+    UINT_PTR *max_end;
+    unsigned count;
+    unsigned capacity;
+    bool sorted;
+    bool max_end_valid;
+    int *pending;                 // Ids of ED_DATAPENDING nodes
+    unsigned pending_count;
+    unsigned pending_capacity;
 };
 
 struct ed_color_picker {
@@ -34,59 +271,424 @@ struct ed_color_picker {
     float original_color[4];
 };
 
-ed_node ed_tree[ED_NODE_COUNT];
 ed_node_update ed_update_funcs[ED_UPDATE_FUNCS_COUNT];
 struct ed_style ed_style;
 struct ed_stats ed_stats;
 
-static unsigned used_node_count;
-static unsigned active_node_count;
-static unsigned registered_update_count;
-static unsigned rect_stack_count;
-static ed_rect rect_stack[ED_RECT_STACK_SIZE];
-static HBRUSH brushes[ED_COLOR_COUNT];
-static HFONT ui_font;
-static struct ed_tree_context ed_ctx;
-static struct ed_tree_context ed_saved_ctx;
-static struct ed_color_picker color_picker;
+// State of one UI tree. Every ed_* call operates on the context made current
+// on the calling thread with `ed_set_context`.
+struct ed_context {
+    ed_node_update *update_funcs; // ed_update_funcs for the default context
+    struct ed_stats *stats;       // ed_stats for the default context
+    unsigned active_node_count;
+    unsigned registered_update_count;
+    unsigned update_offset;       // First update function called by the next ed_update
+    unsigned rect_stack_count;
+    ed_rect rect_stack[ED_RECT_STACK_SIZE];
+    HBRUSH brushes[ED_COLOR_COUNT];
+    HFONT ui_font;
+    struct ed_font_metrics ui_font_metrics; // Metrics of ui_font
+    struct ed_node_arena arena;
+    struct ed_handle_table handles;
+    struct ed_name_index names;
+    struct ed_measure_stack measure_stack;
+    struct ed_node_queue geometry;
+    struct ed_node_queue reflow;  // Nodes queued by ed_mark_dirty
+    struct ed_sync_table sync;
+    struct ed_range_index ranges;
+    unsigned layout_depth;
+    ed_backend backend;
+    HDWP defer_pos;               // Batch of the Win32 backend
+    bool redraw_suppressed;
+    struct ed_tree_context tree;
+    struct ed_tree_context saved_tree;
+    struct ed_color_picker color_picker;
+
+    // Storage for update_funcs and stats in contexts created with
+    // ed_create_context.
+    ed_node_update own_update_funcs[ED_UPDATE_FUNCS_COUNT];
+    struct ed_stats own_stats;
+};
+
+// update_funcs and stats of the default context are set by ed_init.
+static struct ed_context ed_default_context;
+static ED_THREAD_LOCAL struct ed_context *ed_current = &ed_default_context;
+static INIT_ONCE ed_shared_init_once = INIT_ONCE_STATIC_INIT;
+
+static struct ed_node_chunk *
+ed_node_chunk(int id)
+{
+    unsigned chunk_index = (unsigned)id / ED_TREE_CHUNK_SIZE;
+    assert(chunk_index < ed_current->arena.chunk_count);
+    return &ed_current->arena.chunks[chunk_index];
+}
 
 static ed_node *
 ed_alloc_node(void)
 {
+    unsigned chunk_index = ed_current->arena.free_chunk;
+    struct ed_node_chunk *chunk = NULL;
+
+    for (; chunk_index < ed_current->arena.chunk_count; ++chunk_index) {
+        chunk = &ed_current->arena.chunks[chunk_index];
+        if (!chunk->nodes || chunk->removed || chunk->used < ED_TREE_CHUNK_SIZE) {
+            break;
+        }
+    }
+
+    if (chunk_index == ed_current->arena.chunk_count) {
+        if (ed_current->arena.chunk_count == ed_current->arena.chunk_capacity) {
+            unsigned capacity = ed_max(2 * ed_current->arena.chunk_capacity, 16);
+            struct ed_node_chunk *chunks = (struct ed_node_chunk *)realloc(
+                    ed_current->arena.chunks, capacity * sizeof(struct ed_node_chunk));
+            assert(chunks && "out of memory.");
+
+            ed_current->arena.chunks = chunks;
+            ed_current->arena.chunk_capacity = capacity;
+        }
+
+        chunk = &ed_current->arena.chunks[chunk_index];
+        memset(chunk, 0, sizeof(struct ed_node_chunk));
+        ++ed_current->arena.chunk_count;
+    }
+
+    ed_current->arena.free_chunk = chunk_index;
+
+    if (!chunk->nodes) {
+        chunk->nodes = (ed_node *)calloc(ED_TREE_CHUNK_SIZE, sizeof(ed_node));
+        chunk->bindings = (ed_node_binding *)calloc(ED_TREE_CHUNK_SIZE,
+                sizeof(ed_node_binding));
+        assert(chunk->nodes && chunk->bindings && "out of memory.");
+
+        // Id 0 is never handed out.
+        chunk->used = chunk_index == 0 ? ED_ID_ROOT : 0;
+    } else if (chunk->active == 0) {
+        --ed_current->arena.empty_chunks;
+    }
+
     ed_node *node;
-    if (ed_ctx.removed) {
-        node = ed_ctx.removed;
-        ed_ctx.removed = node->node_list;
-        short id = node->id;
+    if (chunk->removed) {
+        node = chunk->removed;
+        chunk->removed = node->after;
         memset(node, 0, sizeof(ed_node));
-        node->id = id;
+        memset(&chunk->bindings[node - chunk->nodes], 0, sizeof(ed_node_binding));
     } else {
-        ++used_node_count;
-        node = &ed_tree[used_node_count];
-        node->id = (short)used_node_count;
+        node = &chunk->nodes[chunk->used];
+        ++chunk->used;
     }
 
-    ++active_node_count;
+    node->id = (int)(chunk_index * ED_TREE_CHUNK_SIZE + (unsigned)(node - chunk->nodes));
+    node->dirty = ED_DIRTY_MEASURE;
+    ++chunk->active;
+    ++ed_current->active_node_count;
     return node;
 }
 
+// Invalidates all copies of `handle` and makes its slot available for reuse.
+static void
+ed_free_handle(ed_handle handle)
+{
+    unsigned index = handle & ED_HANDLE_INDEX_MASK;
+    struct ed_handle_slot *slot = &ed_current->handles.slots[index];
+
+    slot->id = 0;
+    if (slot->generation == ED_HANDLE_GENERATION_MASK) {
+        // Another generation would wrap around to handles given out before.
+        return;
+    }
+
+    ++slot->generation;
+    slot->next_free = ed_current->handles.free_slot;
+    ed_current->handles.free_slot = index;
+}
+
+static void
+ed_queue_push(struct ed_node_queue *queue, ed_node *node)
+{
+    if (queue->count == queue->capacity) {
+        unsigned capacity = queue->capacity ? queue->capacity * 2 : 256;
+        ed_node **nodes = (ed_node **)realloc(queue->nodes, capacity * sizeof(ed_node *));
+        assert(nodes && "out of memory.");
+        queue->nodes = nodes;
+        queue->capacity = capacity;
+    }
+    queue->nodes[queue->count++] = node;
+}
+
+// Removes a node from the reflow queue, see `ed_mark_dirty`.
+static void
+ed_unqueue_reflow(ed_node *node)
+{
+    struct ed_node_queue *queue = &ed_current->reflow;
+    for (unsigned i = 0; i < queue->count; ++i) {
+        if (queue->nodes[i] == node) {
+            queue->nodes[i] = queue->nodes[--queue->count];
+            break;
+        }
+    }
+    node->dirty &= ~ED_DIRTY_REFLOW;
+}
+
+// Adds a node to the released list of its chunk. The node is not available
+// for reuse until `ed_splice_released` is called.
+static void
+ed_release_node(ed_node *node, struct ed_node_chunk **released_chunks)
+{
+    struct ed_node_chunk *chunk = ed_node_chunk(node->id);
+    ed_node_binding *binding = &chunk->bindings[(unsigned)node->id % ED_TREE_CHUNK_SIZE];
+
+    if (binding->handle) {
+        ed_free_handle(binding->handle);
+        binding->handle = ED_HANDLE_NULL;
+    }
+    if (node->dirty & ED_DIRTY_REFLOW) {
+        ed_unqueue_reflow(node);
+    }
+
+    node->type = ED_NONE;
+    node->after = chunk->released;
+    chunk->released = node;
+
+    if (!chunk->released_tail) {
+        chunk->released_tail = node;
+        chunk->next_released = *released_chunks;
+        *released_chunks = chunk;
+    }
+    ++chunk->released_count;
+}
+
+// Moves the released nodes of each chunk in `released_chunks` to the chunk
+// free list in one step. A chunk is freed once none of its nodes are in use,
+// unless it is the only empty chunk.
+static void
+ed_splice_released(struct ed_node_chunk *released_chunks)
+{
+    struct ed_node_chunk *next;
+    for (struct ed_node_chunk *chunk = released_chunks; chunk; chunk = next) {
+        unsigned chunk_index = (unsigned)(chunk - ed_current->arena.chunks);
+        next = chunk->next_released;
+
+        chunk->released_tail->after = chunk->removed;
+        chunk->removed = chunk->released;
+        chunk->active -= chunk->released_count;
+        ed_current->active_node_count -= chunk->released_count;
+
+        chunk->released = NULL;
+        chunk->released_tail = NULL;
+        chunk->released_count = 0;
+        chunk->next_released = NULL;
+
+        if (chunk_index < ed_current->arena.free_chunk) {
+            ed_current->arena.free_chunk = chunk_index;
+        }
+
+        if (chunk->active == 0) {
+            if (ed_current->arena.empty_chunks > 0) {
+                free(chunk->nodes);
+                free(chunk->bindings);
+                chunk->nodes = NULL;
+                chunk->bindings = NULL;
+                chunk->removed = NULL;
+                chunk->used = 0;
+            } else {
+                ++ed_current->arena.empty_chunks;
+            }
+        }
+    }
+}
+
+// Returns the id of the nearest named ancestor of `node`.
+static int
+ed_name_scope(ed_node *node)
+{
+    ed_node *p = node->parent;
+    while (p->parent && !ed_binding(p)->name) {
+        p = p->parent;
+    }
+    return p->id;
+}
+
+static unsigned
+ed_hash_name(const char *name, size_t len, int scope)
+{
+    // FNV-1a
+    unsigned hash = 2166136261u ^ (unsigned)scope;
+    for (size_t i = 0; i < len; ++i) {
+        hash = (hash ^ (unsigned char)name[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void
+ed_name_insert_entry(struct ed_name_entry entry)
+{
+    struct ed_name_index *names = &ed_current->names;
+    unsigned mask = names->capacity - 1;
+    unsigned i = entry.hash & mask;
+    while (names->entries[i].id) {
+        i = (i + 1) & mask;
+    }
+    names->entries[i] = entry;
+    ++names->count;
+}
+
+// Adds a named node to the name index of the current context.
+static void
+ed_name_insert(ed_node *node)
+{
+    struct ed_name_index *names = &ed_current->names;
+    ed_node_binding *binding = ed_binding(node);
+
+    if (4 * (names->count + 1) > 3 * names->capacity) {
+        struct ed_name_entry *entries = names->entries;
+        unsigned capacity = names->capacity;
+
+        names->capacity = ed_max(2 * capacity, 64);
+        names->count = 0;
+        names->entries = (struct ed_name_entry *)calloc(names->capacity,
+                sizeof(struct ed_name_entry));
+        assert(names->entries && "out of memory.");
+
+        for (unsigned i = 0; i < capacity; ++i) {
+            if (entries[i].id) ed_name_insert_entry(entries[i]);
+        }
+        free(entries);
+    }
+
+    struct ed_name_entry entry;
+    entry.scope = ed_name_scope(node);
+    entry.hash = ed_hash_name(binding->name, strlen(binding->name), entry.scope);
+    entry.id = node->id;
+    binding->name_hash = entry.hash;
+    ed_name_insert_entry(entry);
+}
+
+// Removes a named node from the name index of the current context.
+static void
+ed_name_erase(ed_node *node)
+{
+    struct ed_name_index *names = &ed_current->names;
+    unsigned mask = names->capacity - 1;
+    unsigned i = ed_binding(node)->name_hash & mask;
+
+    while (names->entries[i].id != node->id) {
+        assert(names->entries[i].id && "named node missing from index.");
+        i = (i + 1) & mask;
+    }
+
+    // Shift back entries which would no longer be reachable from their hash.
+    for (unsigned j = (i + 1) & mask; names->entries[j].id; j = (j + 1) & mask) {
+        unsigned home = names->entries[j].hash & mask;
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            names->entries[i] = names->entries[j];
+            i = j;
+        }
+    }
+    names->entries[i].id = 0;
+    --names->count;
+}
+
+// Removes the ed_bind entry and the ed_bind_version block of a node, the last
+// entry or block takes its slot.
+static void
+ed_sync_remove(ed_node_binding *binding)
+{
+    struct ed_sync_table *table = &ed_current->sync;
+
+    if (binding->sync_slot) {
+        unsigned index = binding->sync_slot - 1;
+        binding->sync_slot = 0;
+
+        if (index != --table->count) {
+            table->entries[index] = table->entries[table->count];
+            ed_binding(ed_index_node(table->entries[index].id))->sync_slot = index + 1;
+        }
+    }
+
+    if (binding->sync_block) {
+        unsigned index = binding->sync_block - 1;
+        binding->sync_block = 0;
+
+        if (index != --table->block_count) {
+            table->blocks[index] = table->blocks[table->block_count];
+            ed_binding(ed_index_node(table->blocks[index].id))->sync_block = index + 1;
+        }
+    }
+}
+
+// Removes the value range of a node from the range index, and the node from
+// the nodes pending a refresh.
+static void
+ed_range_remove(ed_node *node)
+{
+    struct ed_range_index *index = &ed_current->ranges;
+    ed_node_binding *binding = ed_binding(node);
+
+    if (binding->range_slot) {
+        unsigned i = binding->range_slot - 1;
+        binding->range_slot = 0;
+
+        if (i != --index->count) {
+            index->ranges[i] = index->ranges[index->count];
+            ed_binding(ed_index_node(index->ranges[i].id))->range_slot = i + 1;
+        }
+        index->sorted = false;
+    }
+
+    if (node->flags & ED_DATAPENDING) {
+        node->flags &= ~ED_DATAPENDING;
+        for (unsigned i = 0; i < index->pending_count; ++i) {
+            if (index->pending[i] == node->id) {
+                index->pending[i] = index->pending[--index->pending_count];
+                break;
+            }
+        }
+    }
+}
+
 static void
 ed_free_node_resources(ed_node *node)
 {
-    if (node->value_ptr && (node->flags & ED_OWNDATA)) {
-        switch (node->value_type) {
+    ed_node_binding *binding = ed_binding(node);
+
+    if (binding->name) {
+        ed_name_erase(node);
+        free(binding->name);
+        binding->name = NULL;
+    }
+
+    if (binding->list) {
+        free(binding->list);
+        binding->list = NULL;
+    }
+
+    if (binding->grid) {
+        free(binding->grid);
+        binding->grid = NULL;
+    }
+
+    if (binding->value_ptr && (node->flags & ED_OWNDATA)) {
+        switch (binding->value_type) {
         case ED_DIB:
-        case ED_BITMAP: DeleteObject((HBITMAP)node->value_ptr); break;
-        case ED_ICON: DestroyIcon((HICON)node->value_ptr); break;
+        case ED_BITMAP: DeleteObject((HBITMAP)binding->value_ptr); break;
+        case ED_ICON: DestroyIcon((HICON)binding->value_ptr); break;
         default:
             assert(!"invalid use of ED_OWNDATA flag.");
         }
-        node->value_ptr = NULL;
+        binding->value_ptr = NULL;
     }
 
     if (node->flags & ED_OWNUPDATE) {
         ed_unregister_update(node);
     }
+
+    if (binding->sync_slot || binding->sync_block) {
+        ed_sync_remove(binding);
+    }
+
+    if (binding->range_slot || (node->flags & ED_DATAPENDING)) {
+        ed_range_remove(node);
+    }
 }
 
 static void
@@ -101,26 +703,27 @@ ed_destroy_node(ed_node *node)
 static ed_node *
 ed_attach(ed_node_type type, float x, float y, float w, float h)
 {
-    assert(ed_ctx.parent && "cannot add child node without a parent.");
+    assert(ed_current->tree.parent && "cannot add child node without a parent.");
     ed_node *node = ed_alloc_node();
     node->type = type;
     node->rect.x = x;
     node->rect.y = y;
     node->rect.w = w;
     node->rect.h = h;
-    node->parent = ed_ctx.parent;
-
-    if (!ed_ctx.parent->child) {
-        ed_ctx.parent->child = node;
-    } else if (ed_ctx.child) {
-        if (ed_ctx.child->after) {
-            ed_ctx.child->after->before = node;
-            node->after = ed_ctx.child->after;
+    node->parent = ed_current->tree.parent;
+
+    if (!ed_current->tree.parent->child) {
+        ed_current->tree.parent->child = node;
+    } else if (ed_current->tree.child) {
+        if (ed_current->tree.child->after) {
+            ed_current->tree.child->after->before = node;
+            node->after = ed_current->tree.child->after;
         }
-        ed_ctx.child->after = node;
-        node->before = ed_ctx.child;
+        ed_current->tree.child->after = node;
+        node->before = ed_current->tree.child;
     }
-    ed_ctx.child = node;
+    ed_current->tree.child = node;
+    ed_mark_dirty(node);
     return node;
 }
 
@@ -128,24 +731,27 @@ static ed_node *
 ed_push(ed_node_type type, float x, float y, float w, float h)
 {
     ed_node *node = ed_attach(type, x, y, w, h);
-    ed_ctx.parent = node;
-    ed_ctx.child = NULL;
+    ed_current->tree.parent = node;
+    ed_current->tree.child = NULL;
     return node;
 }
 
 static void
 ed_pop(void)
 {
-    assert(ed_ctx.parent);
-    int pop_parent = ed_ctx.parent->flags & ED_POPPARENT;
+    ed_node *node = ed_current->tree.parent;
+    assert(node);
+    int pop_parent = node->flags & ED_POPPARENT;
 
-    ed_ctx.parent = ed_ctx.parent->parent;
-    if (ed_ctx.parent) {
-        ed_ctx.child = ed_ctx.parent->child;
+    // Continue after the last sibling. Walk from the node being closed, which
+    // is usually the last one, so appending children stays linear.
+    ed_current->tree.parent = node->parent;
+    if (ed_current->tree.parent) {
+        ed_current->tree.child = node;
     }
 
-    while (ed_ctx.child->after) {
-        ed_ctx.child = ed_ctx.child->after;
+    while (ed_current->tree.child->after) {
+        ed_current->tree.child = ed_current->tree.child->after;
     }
 
     if (pop_parent) {
@@ -153,66 +759,102 @@ ed_pop(void)
     }
 }
 
-// Returns the result of a linear search starting from `node`. The search
-// does not follow the order of the UI layout.
-//
-// skip_first:
-//   Skip the node passed in to `node`.
+// Returns the result of a linear search starting from node id `start`. The
+// search does not follow the order of the UI layout.
 static ed_node *
-ed_find_node_with_flags(ed_node *node, int mask, bool skip_first)
+ed_find_node_with_flags(int start, int mask)
 {
-    size_t start = skip_first ? node->id + 1 : node->id;
-    for (size_t i = start; i < ARRAYSIZE(ed_tree); ++i) {
-        if (ed_tree[i].type && (ed_tree[i].flags & mask)) {
-            return &ed_tree[i];
+    for (unsigned c = (unsigned)start / ED_TREE_CHUNK_SIZE; c < ed_current->arena.chunk_count; ++c) {
+        struct ed_node_chunk *chunk = &ed_current->arena.chunks[c];
+        if (!chunk->nodes) continue;
+
+        unsigned i = 0;
+        if (c == (unsigned)start / ED_TREE_CHUNK_SIZE) {
+            i = (unsigned)start % ED_TREE_CHUNK_SIZE;
+        }
+
+        for (; i < chunk->used; ++i) {
+            if (chunk->nodes[i].type && (chunk->nodes[i].flags & mask)) {
+                return &chunk->nodes[i];
+            }
         }
     }
     return NULL;
 }
 
-// Returns the first node starting from `node` containing certain flags.
-//
-// skip_first:
-//   Skip the node passed in to `node`.
+// Returns the node after `node` in depth-first order without leaving the
+// subtree of `root`. A NULL `root` walks the rest of the tree.
 static ed_node *
-ed_find_node_with_flags_ordered(ed_node *node, int mask, bool skip_first)
+ed_preorder_next(ed_node *node, ed_node *root)
 {
-    if ((node->flags & mask) && !skip_first) {
-        return node;
-    }
+    if (node->child) return node->child;
 
-    for (ed_node *c = node->child; c; c = c->after) {
-        ed_node *next = ed_find_node_with_flags_ordered(c, mask, false);
-        if (next) return next;
+    while (node != root && !node->after) {
+        node = node->parent;
     }
+    return node == root ? NULL : node->after;
+}
 
-    if (node->after) {
-        return ed_find_node_with_flags_ordered(node->after, mask, false);
+// Same as `ed_preorder_next` with the children of each node visited from last
+// to first.
+static ed_node *
+ed_reverse_preorder_next(ed_node *node, ed_node *root)
+{
+    if (node->child) {
+        ed_node *c = node->child;
+        while (c->after) c = c->after;
+        return c;
     }
 
-    while (node->parent && !node->parent->after) {
+    while (node != root && !node->before) {
         node = node->parent;
     }
+    return node == root ? NULL : node->before;
+}
 
-    if (node->parent) {
-        return ed_find_node_with_flags_ordered(node->parent->after, mask, false);
+// Returns the first node starting from `node` containing certain flags.
+//
+// skip_first:
+//   Skip the node passed in to `node`.
+static ed_node *
+ed_find_node_with_flags_ordered(ed_node *node, int mask, bool skip_first)
+{
+    if ((node->flags & mask) && !skip_first) {
+        return node;
     }
 
+    while ((node = ed_preorder_next(node, NULL)) != NULL) {
+        if (node->flags & mask) return node;
+    }
     return NULL;
 }
 
-// Returns the result of a linear search starting from `node`. The search
-// does not follow the order of the UI layout. Searches in reverse order.
+// Returns the result of a linear search starting from node id `start`. The
+// search does not follow the order of the UI layout. Searches in reverse order.
 //
-// skip_first:
-//   Skip the node passed in to `node`.
+// start:
+//   If negative, the search starts from the last node.
 static ed_node *
-ed_rfind_node_with_flags(ed_node *node, int mask, bool skip_first)
+ed_rfind_node_with_flags(int start, int mask)
 {
-    int start = skip_first ? node->id - 1 : node->id;
-    for (int i = start; i >= 0; --i) {
-        if (ed_tree[i].type && (ed_tree[i].flags & mask)) {
-            return &ed_tree[i];
+    unsigned last = ed_current->arena.chunk_count * ED_TREE_CHUNK_SIZE;
+    if (start < 0 || (unsigned)start >= last) {
+        start = (int)last - 1;
+    }
+
+    for (unsigned c = (unsigned)start / ED_TREE_CHUNK_SIZE + 1; c-- > 0;) {
+        struct ed_node_chunk *chunk = &ed_current->arena.chunks[c];
+        if (!chunk->nodes) continue;
+
+        unsigned i = chunk->used;
+        if (c == (unsigned)start / ED_TREE_CHUNK_SIZE) {
+            i = ed_min(i, (unsigned)start % ED_TREE_CHUNK_SIZE + 1);
+        }
+
+        while (i-- > 0) {
+            if (chunk->nodes[i].type && (chunk->nodes[i].flags & mask)) {
+                return &chunk->nodes[i];
+            }
         }
     }
     return NULL;
@@ -230,52 +872,89 @@ ed_rfind_node_with_flags_ordered(ed_node *node, int mask, bool skip_first)
         return node;
     }
 
-    if (node->child) {
-        ed_node *c = node->child;
-        for (;; c = c->after) {
-            if (!c->after) break;
-        }
-        for (; c; c = c->before) {
-            ed_node *previous = ed_rfind_node_with_flags_ordered(c, mask, false);
-            if (previous) return previous;
-        }
+    while ((node = ed_reverse_preorder_next(node, NULL)) != NULL) {
+        if (node->flags & mask) return node;
     }
+    return NULL;
+}
 
-    if (node->before) {
-        return ed_rfind_node_with_flags_ordered(node->before, mask, false);
+// Returns true if the node takes up space in the layout. Nodes are hidden by
+// ed_hide and ed_collapse, scrollbars are visible when their client
+// overflows, which is decided during ed_measure before the window is shown.
+// Parents are not checked, measure and layout don't descend into hidden
+// nodes.
+static bool
+ed_is_node_visible(ed_node *node)
+{
+    if (node->type == ED_SCROLLBAR) {
+        return (ed_index_node(node->scroll_client)->flags & ED_OVERFLOW) != 0;
     }
+    return !(node->flags & ED_HIDDEN);
+}
 
-    while (node->parent && !node->parent->before) {
-        node = node->parent;
+// Reads the advance widths and height of `font`. Must be called again
+// whenever the font changes.
+static void
+ed_load_font_metrics(struct ed_font_metrics *metrics, HFONT font)
+{
+    HDC hdc = GetDC(NULL);
+    HGDIOBJ old_font = SelectObject(hdc, font);
+
+    if (!GetCharWidth32A(hdc, 0, 255, metrics->advance)) {
+        memset(metrics->advance, 0, sizeof metrics->advance);
     }
 
-    if (node->parent) {
-        return ed_rfind_node_with_flags_ordered(node->parent->before, mask, false);
+    TEXTMETRICA tm;
+    metrics->height = GetTextMetricsA(hdc, &tm) ? (int)tm.tmHeight : 0;
+
+    SelectObject(hdc, old_font);
+    ReleaseDC(NULL, hdc);
+}
+
+// Returns the size of the first `len` bytes of `text` drawn on one line with
+// the font of `metrics`. Text is in the ANSI code page, like the window text,
+// and no kerning is applied, like GetTextExtentPoint32. Makes no system
+// calls, so it can be used from any thread.
+static ed_bounds
+ed_text_extent(const struct ed_font_metrics *metrics, const char *text, size_t len)
+{
+    long long w = 0;
+    for (size_t i = 0; i < len; ++i) {
+        w += metrics->advance[(unsigned char)text[i]];
     }
 
-    return NULL;
+    ed_bounds bounds;
+    bounds.w = ed_coord(w);
+    bounds.h = metrics->height;
+    return bounds;
 }
 
-static void
-ed_measure_text_bounds(ed_node *node)
+// Measures the size of `text`, which is or is about to become the window text
+// of `node`. Returns true if the size changed.
+static bool
+ed_measure_text_bounds(ed_node *node, const char *text)
 {
-    int len = GetWindowTextLengthA(ed_hwnd(node));
-    char *text = (char *)_malloca(len + 1);
+    ed_bounds bounds = node->bounds;
+    if (!text) text = "";
 
-    SIZE ext;
-    HDC hdc = GetDC(ed_hwnd(node));
-    GetWindowTextA(ed_hwnd(node), text, len + 1);
+    node->bounds = ed_text_extent(&ed_current->ui_font_metrics, text, strlen(text));
+    return bounds.w != node->bounds.w || bounds.h != node->bounds.h;
+}
 
-    if (GetTextExtentPoint32A(hdc, text, len, &ext)) {
-        node->bounds.w = (short)ext.cx;
-        node->bounds.h = (short)ext.cy;
+// Counts the children of `node` and stores the index of each child, used by
+// `ed_measure_spacing`.
+static void
+ed_index_children(ed_node *node)
+{
+    int child_count = 0;
+    for (ed_node *c = node->child; c; c = c->after) {
+        c->child_index = child_count++;
     }
-
-    ReleaseDC(ed_hwnd(node), hdc);
-    _freea(text);
+    node->child_count = child_count;
 }
 
-// Measures the spacing required to layout a child node.
+// Measures the spacing required to layout a child node. Uses the child count
+// and index stored by `ed_index_children`.
 //
 // layout:
 //   Expected parent layout. If the layout does not match this function
@@ -292,8 +971,6 @@ static void
 ed_measure_spacing(ed_node *node, ed_node_layout layout,
         int *total_spacing, int *remaining_spacing)
 {
-    int child_count = 0;
-    int child_index = 0;
     ed_node *p = node->parent;
 
     if (p->layout != layout) {
@@ -302,30 +979,154 @@ ed_measure_spacing(ed_node *node, ed_node_layout layout,
         return;
     }
 
-    for (ed_node *c = p->child; c; c = c->after) {
-        if (c == node) child_index = child_count;
-        ++child_count;
-    }
-
+    int child_count = p->child_count;
+    int child_index = node->child_index;
     *total_spacing = 2 * p->padding + (child_count - 1) * node->spacing;
     *remaining_spacing = p->padding + (child_count - child_index - 1) * node->spacing;
 }
 
-static void
-ed_measure(ed_node *node)
+// Returns the height of the content of a scroll client. The content of a
+// virtual list may exceed the range of its bounds.
+static int
+ed_scroll_extent(ed_node *client)
 {
-    if (!ed_is_visible(node)) {
-        memset(&node->dst, 0, sizeof node->dst);
-        return;
+    if (client->flags & ED_VIRTUALLIST) {
+        struct ed_list *list = ed_binding(client)->list;
+        return ed_coord((long long)list->row_count * list->row_height
+                + 2 * client->padding);
     }
+    return client->bounds.h;
+}
 
-    ed_node *p = node->parent;
-    ed_node *b = node->before;
+static int
+ed_scroll_offset(ed_node *client)
+{
+    if (client->flags & ED_VIRTUALLIST) {
+        return ed_binding(client)->list->scroll;
+    }
+    return client->scroll_pos;
+}
 
-    node->dst.x = (short)node->rect.x;
-    node->dst.y = (short)node->rect.y;
-    node->dst.w = (short)node->rect.w;
-    node->dst.h = (short)node->rect.h;
+// Places a cell of a grid at the origin of its column and row, and sizes it
+// relative to the width of its column. A row starts below the tallest cell of
+// the row before, which was measured before the cells of this row. The grid
+// keeps the height of the running row, cells are measured in order.
+static void
+ed_measure_grid_cell(ed_node *node)
+{
+    ed_node *p = node->parent;
+    struct ed_grid *grid = ed_binding(p)->grid;
+    assert(grid && "grid layout must be created with ed_begin_grid.");
+
+    int column = node->child_index % grid->column_count;
+    struct ed_grid_column *col = &grid->columns[column];
+    int remaining = p->dst.w - 2 * p->padding - grid->fixed_w
+        - (grid->column_count - 1) * grid->spacing;
+    remaining = ed_max(remaining, 0);
+
+    // Round both edges so neighbouring relative columns leave no gaps.
+    int left = (int)(remaining * col->share_x);
+    int right = (int)(remaining * (col->share_x + col->share_w));
+    node->dst.x = p->padding + column * grid->spacing + col->fixed_x + left;
+    if (node->rect.w <= 1.0f && node->rect.w > 0.0f) {
+        node->dst.w = (int)((col->fixed_w + right - left) * node->rect.w);
+    }
+
+    // The cell before is measured, the height of the row so far is known.
+    int row = node->child_index / grid->column_count;
+    ed_node *b = node->before;
+    if (!b) {
+        grid->row = 0;
+        grid->row_y = p->padding;
+        grid->row_h = 0;
+    } else if (grid->row >= 0 && b->child_index / grid->column_count == grid->row) {
+        grid->row_h = ed_max(grid->row_h, b->dst.h);
+    } else {
+        // Cell measured on its own, such as by ed_invalidate. Place it from
+        // the cells before and drop the running row until the next full pass.
+        int y = b->dst.y;
+        if (column == 0) {
+            int row_h = 0;
+            ed_node *a = b;
+            for (int i = 0; i < grid->column_count && a; ++i, a = a->before) {
+                row_h = ed_max(row_h, a->dst.h);
+            }
+            y = ed_coord((long long)b->dst.y + row_h + grid->spacing);
+        }
+        grid->row = -1;
+        node->dst.y = y;
+        return;
+    }
+
+    if (row != grid->row) {
+        grid->row = row;
+        grid->row_y = ed_coord((long long)grid->row_y + grid->row_h + grid->spacing);
+        grid->row_h = 0;
+    }
+    node->dst.y = grid->row_y;
+}
+
+static void ed_measure_subtree(struct ed_measure_stack *stack, ed_node *node, bool fit);
+static void ed_measure_end(struct ed_measure_stack *stack, ed_node *node, bool fit,
+        bool measured_children);
+
+// Returns true if the width of `node` is relative to the width of its parent.
+static bool
+ed_is_relative_w(ed_node *node)
+{
+    return node->rect.w <= 1.0f && node->rect.w > 0.0f
+        && node->parent && node->parent->layout != ED_GRID;
+}
+
+// Sizes a node with w in (0, 1] relative to the width of its parent, and
+// shrinks it to fit the siblings after it.
+static void
+ed_measure_relative_w(struct ed_measure_stack *stack, ed_node *node, bool fit)
+{
+    ed_node *p = node->parent;
+    int total_spc, rem_spc;
+    ed_measure_spacing(node, ED_HORZ, &total_spc, &rem_spc);
+    if (node->rect.x > 1.0f) {
+        // Left margin
+        total_spc += node->dst.x;
+    }
+    node->dst.w = (int)((p->dst.w - total_spc) * node->rect.w);
+
+    // Calculate space remaining in parent to make sure this will fit.
+    int rest = p->dst.w - node->dst.x - rem_spc;
+    if (fit && rest <= node->dst.w && p->layout == ED_HORZ) {
+        // Node doesn't fit, measure the remaining children and shrink
+        // this node accordingly.
+        for (ed_node *a = node->after; a; a = a->after) {
+            ed_measure_subtree(stack, a, false);
+            rest -= a->dst.w;
+        }
+        node->dst.w = rest;
+    }
+}
+
+// Measures the size of a node before its children are measured. Children are
+// only measured again if the node is dirty or the size available to them
+// changed along an axis they depend on, otherwise the bounds from the last
+// measure are used. Returns true if the children must be measured, otherwise
+// the node is finished.
+static bool
+ed_measure_begin(struct ed_measure_stack *stack, ed_node *node, bool fit)
+{
+    if (!ed_is_node_visible(node)) {
+        memset(&node->dst, 0, sizeof node->dst);
+        return false;
+    }
+
+    ++stack->measured_nodes;
+
+    ed_node *p = node->parent;
+    ed_node *b = node->before;
+
+    node->dst.x = (int)node->rect.x;
+    node->dst.y = (int)node->rect.y;
+    node->dst.w = (int)node->rect.w;
+    node->dst.h = (int)node->rect.h;
 
     // Parent padding
     if (p) {
@@ -333,36 +1134,32 @@ ed_measure(ed_node *node)
         node->dst.y += p->padding;
     }
 
+    // Rows of a virtual list are placed by their row index.
+    if (p && (p->flags & ED_VIRTUALLIST)) {
+        struct ed_list *list = ed_binding(p)->list;
+        int index = list->first + (node->child_index - list->first % list->slot_count
+                + list->slot_count) % list->slot_count;
+        node->dst.y = ed_coord(p->padding + (long long)index * list->row_height
+                - list->scroll);
+    }
+
     // Stack layouts
     if (b) {
         if (p->layout == ED_HORZ) {
-            node->dst.x = b->dst.x + b->dst.w + b->spacing;
+            node->dst.x = ed_coord((long long)b->dst.x + b->dst.w + b->spacing);
         } else if (p->layout == ED_VERT) {
-            node->dst.y = b->dst.y + b->dst.h + b->spacing;
+            node->dst.y = ed_coord((long long)b->dst.y + b->dst.h + b->spacing);
         }
     }
 
-    // w in (0, 1] size node relative to parent width.
-    if (node->rect.w <= 1.0f && node->rect.w > 0.0f && p) {
-        int total_spc, rem_spc;
-        ed_measure_spacing(node, ED_HORZ, &total_spc, &rem_spc);
-        if (node->rect.x > 1.0f) {
-            // Left margin
-            total_spc += node->dst.x;
-        }
-        node->dst.w = (short)((p->dst.w - total_spc) * node->rect.w);
+    // Grid layout
+    if (p && p->layout == ED_GRID) {
+        ed_measure_grid_cell(node);
+    }
 
-        // Calculate space remaining in parent to make sure this will fit.
-        short rest = (short)(p->dst.w - node->dst.x - rem_spc);
-        if (rest <= node->dst.w && p->layout == ED_HORZ) {
-            // Node doesn't fit, measure the remaining children and shrink
-            // this node accordingly.
-            for (ed_node *a = node->after; a; a = a->after) {
-                ed_measure(a);
-                rest -= a->dst.w;
-            }
-            node->dst.w = rest;
-        }
+    // w in (0, 1] size node relative to parent width.
+    if (ed_is_relative_w(node)) {
+        ed_measure_relative_w(stack, node, fit);
     }
 
     // h in (0, 1] size node relative to parent height.
@@ -373,13 +1170,13 @@ ed_measure(ed_node *node)
             // Top margin
             total_spc += node->dst.y;
         }
-        node->dst.h = (short)((p->dst.h - total_spc) * node->rect.h);
+        node->dst.h = (int)((p->dst.h - total_spc) * node->rect.h);
 
         // Calculate space remaining in parent to make sure this will fit.
-        short rest = (short)(p->dst.h - node->dst.y - rem_spc);
-        if (rest <= node->dst.h && p->layout == ED_VERT) {
+        int rest = p->dst.h - node->dst.y - rem_spc;
+        if (fit && rest <= node->dst.h && p->layout == ED_VERT) {
             for (ed_node *a = node->after; a; a = a->after) {
-                ed_measure(a);
+                ed_measure_subtree(stack, a, false);
                 rest -= a->dst.h;
             }
             node->dst.h = rest;
@@ -388,34 +1185,127 @@ ed_measure(ed_node *node)
 
     // w=0 or h=0 text node size depends on bounds of the text.
     if (node->flags & ED_TEXTNODE) {
-        short border = (node->flags & ED_BORDER) ? 1 : 0;
+        int border = (node->flags & ED_BORDER) ? 1 : 0;
         if (node->rect.w == 0) {
-            node->dst.w = (short)node->bounds.w + ed_style.text_w_spacing * border;
+            node->dst.w = node->bounds.w + ed_style.text_w_spacing * border;
         }
 
         if (node->rect.h == 0) {
-            node->dst.h = (short)node->bounds.h + ed_style.text_h_spacing * border;
+            node->dst.h = node->bounds.h + ed_style.text_h_spacing * border;
         }
     }
 
     ed_node *c = node->child;
-    if (c) {
-        memset(&node->bounds, 0, sizeof node->bounds);
+    if (c && !(node->dirty & (ED_DIRTY_MEASURE | ED_DIRTY_CHILD))) {
+        // Children did not change. They only need to be measured again if the
+        // size available to them changed along an axis they depend on.
+        ++stack->cache_lookups;
+        bool w_changed = (node->measure_axes & ED_AXIS_W)
+            && node->measured_w != node->dst.w;
+        bool h_changed = (node->measure_axes & ED_AXIS_H)
+            && node->measured_h != node->dst.h;
+
+        if (!w_changed && !h_changed) {
+            ++stack->cache_hits;
+            c = NULL;
+            if (node->rect.w == 0.0f) node->dst.w = node->bounds.w;
+            if (node->rect.h == 0.0f || (node->flags & ED_COLLAPSED)) {
+                node->dst.h = node->bounds.h;
+            }
+        }
+    }
 
-        for (;; c = c->after) {
-            ed_measure(c);
-            node->bounds.w = ed_max(node->bounds.w, c->dst.x + c->dst.w + c->spacing);
-            node->bounds.h = ed_max(node->bounds.h, c->dst.y + c->dst.h + c->spacing);
+    if (!c) {
+        ed_measure_end(stack, node, fit, false);
+        return false;
+    }
 
-            if (node->flags & ED_COLLAPSED) {
-                // Node is collapsed, size matches first child.
-                break;
-            }
-            if (!c->after) {
-                break;
-            }
+    node->measured_w = node->dst.w;
+    node->measured_h = node->dst.h;
+    node->measure_axes = 0;
+    node->dirty |= ED_DIRTY_LAYOUT;
+    memset(&node->bounds, 0, sizeof node->bounds);
+    ed_index_children(node);
+    return true;
+}
+
+// Returns the axes of `node` child `c` is sized or positioned relative to.
+static int
+ed_measure_child_axes(ed_node *node, ed_node *c)
+{
+    int axes = 0;
+    if ((c->rect.w <= 1.0f && c->rect.w > 0.0f) || (c->rect.x <= 1.0f && c->rect.x > 0.0f)
+            || node->layout == ED_GRID) {
+        // Cells of a grid are placed in columns sized by the grid width.
+        axes |= ED_AXIS_W;
+    }
+    if ((c->rect.h <= 1.0f && c->rect.h > 0.0f) || (c->rect.y <= 1.0f && c->rect.y > 0.0f)) {
+        axes |= ED_AXIS_H;
+    }
+    return axes;
+}
+
+// Adds the space taken by child `c` to the bounds of `node`, and the axes of
+// `node` the child was sized or positioned relative to.
+static void
+ed_measure_add_child(ed_node *node, ed_node *c)
+{
+    int w = ed_coord((long long)c->dst.x + c->dst.w + c->spacing);
+    int h = ed_coord((long long)c->dst.y + c->dst.h + c->spacing);
+    node->bounds.w = ed_max(node->bounds.w, w);
+    node->bounds.h = ed_max(node->bounds.h, h);
+    node->measure_axes |= ed_measure_child_axes(node, c);
+}
+
+// Measures again the children of a scroll client whose width changed because
+// its scrollbar was shown or hidden. Only the children sized or positioned
+// relative to the client width are measured, and in a horizontal layout the
+// siblings placed after them.
+static void
+ed_measure_scroll_width(struct ed_measure_stack *stack, ed_node *node, bool fit)
+{
+    int w = node->dst.w;
+    if (ed_is_relative_w(node)) {
+        ed_measure_relative_w(stack, node, fit);
+    }
+    if (node->dst.w == w || !(node->measure_axes & ED_AXIS_W)) {
+        return;
+    }
+
+    bool measure_after = false;
+    for (ed_node *c = node->child; c; c = c->after) {
+        if (measure_after || (ed_measure_child_axes(node, c) & ED_AXIS_W)) {
+            ed_measure_subtree(stack, c, true);
+            measure_after = node->layout == ED_HORZ;
         }
+        if (node->flags & ED_COLLAPSED) break;
+    }
+
+    node->measured_w = node->dst.w;
+    node->measure_axes = 0;
+    node->dirty |= ED_DIRTY_LAYOUT;
+    memset(&node->bounds, 0, sizeof node->bounds);
+    for (ed_node *c = node->child; c; c = c->after) {
+        ed_measure_add_child(node, c);
+        if (node->flags & ED_COLLAPSED) break;
+    }
+    if (node->rect.h == 0.0f || (node->flags & ED_COLLAPSED)) {
+        node->dst.h = node->bounds.h;
+    }
+}
+
+// Finishes measuring a node once its children are measured, shows or hides its
+// scrollbar and positions the node relative to its parent.
+//
+// measured_children:
+//   The children were measured, size the node from their bounds.
+static void
+ed_measure_end(struct ed_measure_stack *stack, ed_node *node, bool fit,
+        bool measured_children)
+{
+    ed_node *p = node->parent;
 
+    if (measured_children) {
         // w=0 size node based on total width of children.
         if (node->rect.w == 0.0f) {
             node->dst.w = node->bounds.w;
@@ -426,90 +1316,558 @@ ed_measure(ed_node *node)
         if (node->rect.h == 0.0f || (node->flags & ED_COLLAPSED)) {
             node->dst.h = node->bounds.h;
         }
+    }
 
-        if (node->scroll_bar) {
-            ed_node *scroll_bar = ed_index_node(node->scroll_bar);
-            BOOL scroll_bar_visible = ed_is_visible(scroll_bar);
-            if (node->bounds.h > node->dst.h) {
-                if (!scroll_bar_visible) {
-                    ShowWindow(ed_hwnd(scroll_bar), SW_SHOW);
-
-                    // Re-measure parent to account for the scrollbar being visible
-                    ed_measure(node->parent);
-                    return;
-                }
-            } else if (scroll_bar_visible) {
-                ShowWindow(ed_hwnd(scroll_bar), SW_HIDE);
-                ed_measure(node->parent);
-                return;
-            }
+    if (node->scroll_bar && (node->child || (node->flags & ED_VIRTUALLIST))) {
+        // The bounds of skipped children are still valid, a scroll client
+        // resized along its height only needs this check. The extent of a
+        // virtual list is known before its rows are created.
+        bool overflow = ed_scroll_extent(node) > node->dst.h;
+        bool scroll_bar_visible = (node->flags & ED_OVERFLOW) != 0;
+        if (overflow != scroll_bar_visible) {
+            // Size the client with or without the space taken by the
+            // scrollbar, which is measured after the client by the parent.
+            // The window is shown or hidden during ed_layout.
+            node->flags ^= ED_OVERFLOW;
+            ed_measure_scroll_width(stack, node, fit);
         }
     }
 
+    node->dirty &= ~(ED_DIRTY_MEASURE | ED_DIRTY_CHILD);
+
     // x in (0, 1] position node relative to parent width.
     if (node->rect.x <= 1.0f && node->rect.x > 0.0f) {
-        node->dst.x = (short)(p->dst.w * node->rect.x - node->dst.w * node->rect.x);
-        node->dst.x -= p->padding * (short)node->rect.x;
+        node->dst.x = (int)(p->dst.w * node->rect.x - node->dst.w * node->rect.x);
+        node->dst.x -= p->padding * (int)node->rect.x;
     }
 
     // y in (0, 1] position node relative to parent height.
     if (node->rect.y <= 1.0f && node->rect.y > 0.0f) {
-        node->dst.y = (short)(p->dst.h * node->rect.y - node->dst.h * node->rect.y);
-        node->dst.y -= p->padding * (short)node->rect.y;
+        node->dst.y = (int)(p->dst.h * node->rect.y - node->dst.h * node->rect.y);
+        node->dst.y -= p->padding * (int)node->rect.y;
     }
 }
 
+// Pushes `node` on `stack`, its children are measured before it is popped.
 static void
-ed_layout(ed_node *node)
+ed_measure_push(struct ed_measure_stack *stack, ed_node *node, bool fit)
 {
-    // Don't modify root or user windows since we don't own them.
-    if (node->id != ED_ID_ROOT && node->type != ED_USERWINDOW) {
-        if (!ed_is_visible(node)) {
-            return;
+    if (stack->count == stack->capacity) {
+        unsigned capacity = stack->capacity ? stack->capacity * 2 : 64;
+        struct ed_measure_frame *frames = (struct ed_measure_frame *)realloc(
+                stack->frames, capacity * sizeof(struct ed_measure_frame));
+        assert(frames && "out of memory.");
+        stack->frames = frames;
+        stack->capacity = capacity;
+    }
+
+    struct ed_measure_frame *frame = &stack->frames[stack->count++];
+    frame->node = node;
+    frame->child = node->child;
+    frame->fit = fit;
+}
+
+// Measures `node` and its children. The subtree is walked with an explicit
+// stack rather than recursion.
+static void
+ed_measure_subtree(struct ed_measure_stack *stack, ed_node *node, bool fit)
+{
+    if (!ed_measure_begin(stack, node, fit)) {
+        return;
+    }
+
+    // Frames below `base` belong to an ed_measure call further up, the array
+    // may move when a nested call grows it.
+    unsigned base = stack->count;
+    ed_measure_push(stack, node, fit);
+
+    while (stack->count > base) {
+        struct ed_measure_frame *frame = &stack->frames[stack->count - 1];
+        ed_node *c = frame->child;
+
+        if (c) {
+            // Node is collapsed, size matches first child.
+            frame->child = (frame->node->flags & ED_COLLAPSED) ? NULL : c->after;
+            if (ed_measure_begin(stack, c, true)) {
+                ed_measure_push(stack, c, true);
+            } else {
+                ed_measure_add_child(c->parent, c);
+            }
+            continue;
+        }
+
+        ed_node *done = frame->node;
+        bool done_fit = frame->fit;
+        --stack->count;
+
+        ed_measure_end(stack, done, done_fit, true);
+        if (stack->count > base) {
+            ed_measure_add_child(done->parent, done);
+        }
+    }
+}
+
+// Measures the size and position of a node and its children relative to the
+// parent.
+//
+// fit:
+//   Shrink a relatively sized node that does not fit in its parent's stack
+//   layout. The siblings after such a node are measured once with `fit`
+//   unset to find the space they need, so each sibling list is measured in
+//   linear time.
+static void
+ed_measure(ed_node *node, bool fit)
+{
+    struct ed_measure_stack *stack = &ed_current->measure_stack;
+    ed_measure_subtree(stack, node, fit);
+    ed_current->stats->measured_nodes += stack->measured_nodes;
+    ed_current->stats->measure_cache_lookups += stack->cache_lookups;
+    ed_current->stats->measure_cache_hits += stack->cache_hits;
+    stack->measured_nodes = 0;
+    stack->cache_lookups = 0;
+    stack->cache_hits = 0;
+}
+
+static void ed_layout(ed_node *node);
+
+// Binds a row slot of a virtual list, or hides it if the list has fewer rows
+// than slots. The window is shown or hidden by the next commit.
+static void
+ed_list_bind_row(struct ed_list *list, ed_node *row, int index)
+{
+    if (index < list->row_count) {
+        row->flags &= ~ED_HIDDEN;
+        list->bind(row, index);
+    } else {
+        row->flags |= ED_HIDDEN;
+    }
+    ed_mark_dirty(row);
+}
+
+// Creates enough row slots to fill the viewport of a virtual list client and
+// binds the rows which came into view since the last update. Every slot is
+// measured again since its position depends on the scroll position, the
+// caller lays them out.
+//
+// rebind:
+//   Bind every slot, even if its row is still in view.
+static void
+ed_list_update(ed_node *client, bool rebind)
+{
+    struct ed_list *list = ed_binding(client)->list;
+
+    int visible = client->dst.h / list->row_height + 2;
+    int slot_count = ed_min(visible + 2 * ED_LIST_MARGIN_ROWS, list->row_count);
+    if (slot_count > list->slot_count) {
+        struct ed_tree_context tree = ed_current->tree;
+        ed_current->tree.parent = client;
+        ed_current->tree.child = client->child;
+        while (ed_current->tree.child && ed_current->tree.child->after) {
+            ed_current->tree.child = ed_current->tree.child->after;
         }
 
-        if (node->parent && node->parent->scroll_pos) {
-            node->dst.y -= node->parent->scroll_pos;
+        for (int i = list->slot_count; i < slot_count; ++i) {
+            ed_node *row = ed_begin(ED_HORZ, 0, 0, 1.0f, (float)list->row_height);
+            if (list->build) list->build(row);
+            ed_end();
         }
 
-        ShowWindow(ed_hwnd(node), SW_SHOW);
+        ed_current->tree = tree;
+        list->slot_count = slot_count;
 
-        ed_dst dst = node->dst;
-        if (dst.w == 0) dst.w = 20;
-        if (dst.h == 0) dst.h = 20;
+        // Slots map to different rows once the slot count changes.
+        rebind = true;
+    }
 
-        if (node->type == ED_COMBOBOX) {
-            // A quirk of the combobox api is the height should include the
-            // height of the (invisible) dropdown list.
-            dst.h += node->bounds.h;
+    list->viewport_h = client->dst.h;
+    if (!list->slot_count) {
+        return;
+    }
+
+    int first = list->scroll / list->row_height - ED_LIST_MARGIN_ROWS;
+    int max_first = ed_max(list->row_count - list->slot_count, 0);
+    int previous_first = list->first;
+    list->first = ed_clamp(first, 0, max_first);
+
+    ed_index_children(client);
+    for (ed_node *row = client->child; row; row = row->after) {
+        int index = list->first + (row->child_index - list->first % list->slot_count
+                + list->slot_count) % list->slot_count;
+        if (rebind || index < previous_first
+                || index >= previous_first + list->slot_count) {
+            ed_list_bind_row(list, row, index);
         }
+        ed_measure(row, true);
+    }
+    client->dirty |= ED_DIRTY_LAYOUT;
+}
+
+// Updates the row slots of a virtual list client after scrolling and moves
+// them to their new position.
+static void
+ed_list_refresh(ed_node *client, bool rebind)
+{
+    ed_list_update(client, rebind);
+    ed_layout(client);
+}
+
+static void
+ed_win32_begin_commit(void *user, void *hwnd)
+{
+    (void)user;
+
+    // Enabling redraw shows a hidden window, only suppress it if visible.
+    ed_current->redraw_suppressed = IsWindowVisible((HWND)hwnd) != FALSE;
+    if (ed_current->redraw_suppressed) {
+        SendMessageA((HWND)hwnd, WM_SETREDRAW, FALSE, 0);
+    }
+}
+
+static void
+ed_win32_end_commit(void *user, void *hwnd)
+{
+    (void)user;
+    if (ed_current->redraw_suppressed) {
+        SendMessageA((HWND)hwnd, WM_SETREDRAW, TRUE, 0);
+        ed_current->redraw_suppressed = false;
+    }
+    RedrawWindow((HWND)hwnd, NULL, NULL, RDW_INVALIDATE | RDW_ERASE | RDW_ALLCHILDREN);
+}
 
-        SetWindowPos(ed_hwnd(node), NULL, dst.x, dst.y, dst.w, dst.h,
-                SWP_NOACTIVATE | SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOREDRAW);
+static void
+ed_win32_begin_group(void *user, void *parent, int count)
+{
+    (void)user;
+    (void)parent;
+    ed_current->defer_pos = BeginDeferWindowPos(count);
+}
+
+static void
+ed_win32_end_group(void *user, void *parent)
+{
+    (void)user;
+    (void)parent;
+    if (ed_current->defer_pos) {
+        EndDeferWindowPos(ed_current->defer_pos);
+        ed_current->defer_pos = NULL;
+    }
+}
+
+static void
+ed_win32_set_geometry(void *user, void *hwnd, int x, int y, int w, int h, bool visible)
+{
+    (void)user;
+    UINT flags = SWP_NOACTIVATE | SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOREDRAW;
+    flags |= visible ? SWP_SHOWWINDOW : (SWP_HIDEWINDOW | SWP_NOMOVE | SWP_NOSIZE);
+
+    if (ed_current->defer_pos) {
+        ed_current->defer_pos = DeferWindowPos(ed_current->defer_pos, (HWND)hwnd, NULL,
+                x, y, w, h, flags);
+    }
+    if (!ed_current->defer_pos) {
+        // The batch could not be allocated, move the rest of the group one at
+        // a time.
+        SetWindowPos((HWND)hwnd, NULL, x, y, w, h, flags);
+    }
+}
+
+// Returns the number of pixels of a scroll extent mapped to one unit of the
+// native scrollbar, so the scrollbar range stays within 16 bits.
+static int
+ed_scroll_scale(int extent)
+{
+    return extent / ED_SCROLL_NATIVE_MAX + 1;
+}
+
+static void
+ed_win32_set_scroll(void *user, void *hwnd, int max, int page, int pos)
+{
+    (void)user;
+    int scale = ed_scroll_scale(max);
+    SCROLLINFO si = {0};
+    si.cbSize = sizeof(si);
+    si.fMask = SIF_ALL;
+    si.nMax = max / scale;
+    si.nPage = ed_max(page / scale, 1);
+    si.nPos = pos / scale;
+    si.nTrackPos = si.nPos;
+    SetScrollInfo((HWND)hwnd, SB_CTL, &si, TRUE);
+}
+
+// Applies window geometry with DeferWindowPos. Redraw of the window being laid
+// out is suppressed until the commit ends and issued once.
+static const ed_backend ed_win32_backend = {
+    NULL,
+    ed_win32_begin_commit,
+    ed_win32_end_commit,
+    ed_win32_begin_group,
+    ed_win32_end_group,
+    ed_win32_set_geometry,
+    ed_win32_set_scroll,
+};
+
+// Queues the window of `node` to be moved to its measured position, or hidden
+// for a scrollbar whose client does not overflow.
+static void
+ed_queue_geometry(ed_node *node)
+{
+    if (node->dirty & ED_DIRTY_GEOMETRY) {
+        return;
+    }
+
+    ed_queue_push(&ed_current->geometry, node);
+    node->dirty |= ED_DIRTY_GEOMETRY;
+}
+
+// Geometry committed for a hidden window.
+static const ed_dst ed_hidden_dst = {0, 0, -32768, -32768};
+
+// Returns the window rectangle of a node relative to its parent window.
+static ed_dst
+ed_window_dst(ed_node *node)
+{
+    ed_dst dst = node->dst;
+    if (dst.w == 0) dst.w = 20;
+    if (dst.h == 0) dst.h = 20;
+
+    if (node->parent && node->parent->scroll_pos) {
+        dst.y -= node->parent->scroll_pos;
+    }
+
+    // Native window coordinates are only reliable within 16 bits. Windows
+    // scrolled out of that range are parked just outside the parent, where
+    // they also stop moving while scrolling further.
+    if (dst.y > ED_SCROLL_NATIVE_MAX) {
+        dst.y = ED_SCROLL_NATIVE_MAX;
+    } else if (dst.y < -ED_SCROLL_NATIVE_MAX && dst.y + dst.h < 0) {
+        dst.h = ed_min(dst.h, ED_SCROLL_NATIVE_MAX);
+        dst.y = -dst.h;
+    }
+
+    if (node->type == ED_COMBOBOX) {
+        // A quirk of the combobox api is the height should include the
+        // height of the (invisible) dropdown list.
+        dst.h += node->bounds.h;
+    }
+    return dst;
+}
+
+// Returns true if the window of `node` is shown and hidden by the commit,
+// which is the case for scrollbars and the rows of a virtual list.
+static bool
+ed_is_shown_by_commit(ed_node *node)
+{
+    return node->type == ED_SCROLLBAR || (node->parent->flags & ED_VIRTUALLIST);
+}
+
+// Returns the geometry `node` should have after the commit, or
+// `ed_hidden_dst` for a scrollbar whose client does not overflow and a hidden
+// row of a virtual list.
+static ed_dst
+ed_commit_dst(ed_node *node)
+{
+    if (!ed_is_node_visible(node)) {
+        return ed_hidden_dst;
+    }
+    return ed_window_dst(node);
+}
+
+static bool
+ed_dst_equal(ed_dst a, ed_dst b)
+{
+    return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+}
+
+// Starts the commit before the first native call of ed_commit_geometry, so a
+// layout that changes no window does not suppress or redraw anything.
+static void
+ed_open_commit(ed_node *node, bool *open)
+{
+    if (*open) return;
+    *open = true;
+    ed_backend *backend = &ed_current->backend;
+    backend->begin_commit(backend->user, node->hwnd);
+    ++ed_current->stats->native_calls_issued;
+}
+
+// Sets the range and position of a visible scrollbar from its client, unless
+// they match the values set last.
+static void
+ed_commit_scroll(ed_node *scroll_bar, ed_node *node, bool *open)
+{
+    ed_node *client = ed_index_node(scroll_bar->scroll_client);
+    ed_node_binding *binding = ed_binding(scroll_bar);
+    ed_backend *backend = &ed_current->backend;
+
+    int max = ed_scroll_extent(client);
+    int page = client->dst.h;
+    int pos = ed_scroll_offset(client);
+    if (binding->committed_scroll[0] == max && binding->committed_scroll[1] == page
+            && binding->committed_scroll[2] == pos) {
+        ++ed_current->stats->native_calls_skipped;
+        return;
+    }
+
+    binding->committed_scroll[0] = max;
+    binding->committed_scroll[1] = page;
+    binding->committed_scroll[2] = pos;
+    ed_open_commit(node, open);
+    backend->set_scroll(backend->user, scroll_bar->hwnd, max, page, pos);
+    ++ed_current->stats->native_calls_issued;
+}
+
+// Applies the queued window geometry through the backend of the context.
+// Windows whose geometry matches the last commit are skipped. The remaining
+// windows of each parent are committed as one group, which maps to a single
+// DeferWindowPos batch in the Win32 backend.
+//
+// node:
+//   Node passed to the outermost ed_layout, redrawn once after the commit if
+//   any window changed.
+static void
+ed_commit_geometry(ed_node *node)
+{
+    struct ed_node_queue *queue = &ed_current->geometry;
+    ed_backend *backend = &ed_current->backend;
+    bool open = false;
+
+    for (unsigned i = 0; i < queue->count; ++i) {
+        ed_node *p = queue->nodes[i]->parent;
+        if (!(queue->nodes[i]->dirty & ED_DIRTY_GEOMETRY)) {
+            // Committed with an earlier sibling.
+            continue;
+        }
+
+        // Drop the siblings whose geometry did not change, and count the rest.
+        int count = 0;
+        for (ed_node *c = p->child; c; c = c->after) {
+            if (!(c->dirty & ED_DIRTY_GEOMETRY)) continue;
+
+            if (c->type == ED_SCROLLBAR && ed_is_node_visible(c)) {
+                ed_commit_scroll(c, node, &open);
+            }
+
+            if (ed_dst_equal(ed_commit_dst(c), c->committed)) {
+                c->dirty &= ~ED_DIRTY_GEOMETRY;
+                ++ed_current->stats->native_calls_skipped;
+            } else {
+                ++count;
+            }
+        }
+
+        if (!count) continue;
+
+        ed_open_commit(node, &open);
+        backend->begin_group(backend->user, p->hwnd, count);
+        for (ed_node *c = p->child; c; c = c->after) {
+            if (!(c->dirty & ED_DIRTY_GEOMETRY)) continue;
+            c->dirty &= ~ED_DIRTY_GEOMETRY;
+
+            ed_dst dst = ed_commit_dst(c);
+            bool visible = !ed_dst_equal(dst, ed_hidden_dst);
+            c->committed = dst;
+            backend->set_geometry(backend->user, c->hwnd, dst.x, dst.y, dst.w, dst.h,
+                    visible);
+            ++ed_current->stats->native_calls_issued;
+        }
+        backend->end_group(backend->user, p->hwnd);
+    }
+
+    queue->count = 0;
+    if (open) {
+        backend->end_commit(backend->user, node->hwnd);
+        ++ed_current->stats->native_calls_issued;
+    }
+}
+
+// Moves the window of a node to its measured position. Returns true if the
+// children of the node were measured since the last layout and must be laid
+// out as well.
+static bool
+ed_layout_node(ed_node *node)
+{
+    // Don't modify root or user windows since we don't own them.
+    if (node->id != ED_ID_ROOT && node->type != ED_USERWINDOW) {
+        if (!ed_is_node_visible(node)) {
+            if (ed_is_shown_by_commit(node)) {
+                ed_queue_geometry(node);
+            }
+            return false;
+        }
+
+        ++ed_current->stats->laid_out_nodes;
+        ed_queue_geometry(node);
 
         if (node->type == ED_SCROLLBAR) {
             assert(node->scroll_client
                     && "scrollbar is missing a client window.");
             ed_node *client = ed_index_node(node->scroll_client);
 
-            // Pin client when size changes.
-            if (client->scroll_pos + client->dst.h > client->bounds.h) {
-                client->scroll_pos = client->bounds.h - client->dst.h;
+            // Pin client when size changes. Children of the client may have
+            // been laid out already, move them to the new position.
+            int extent = ed_scroll_extent(client);
+            int max_scroll_pos = ed_max(extent - client->dst.h, 0);
+            if (ed_scroll_offset(client) > max_scroll_pos) {
+                if (client->flags & ED_VIRTUALLIST) {
+                    ed_binding(client)->list->scroll = max_scroll_pos;
+                    ed_list_refresh(client, false);
+                } else {
+                    client->scroll_pos = max_scroll_pos;
+                    for (ed_node *c = client->child; c; c = c->after) {
+                        ed_layout(c);
+                    }
+                }
             }
 
-            SCROLLINFO si = {0};
-            si.cbSize = sizeof(si);
-            si.fMask = SIF_ALL;
-            si.nMax = client->bounds.h;
-            si.nPage = client->dst.h;
-            si.nPos = client->scroll_pos;
-            si.nTrackPos = client->scroll_pos;
-            SetScrollInfo(ed_hwnd(node), SB_CTL, &si, TRUE);
         }
     }
 
-    for (ed_node *c = node->child; c; c = c->after) {
-        ed_layout(c);
+    if ((node->flags & ED_VIRTUALLIST)
+            && ed_binding(node)->list->viewport_h != node->dst.h) {
+        // Viewport was resized, the list may need more row slots.
+        ed_list_update(node, false);
+    }
+
+    if (node->scroll_bar) {
+        // The scrollbar may have been toggled by invalidating the client alone.
+        ed_node *scroll_bar = ed_index_node(node->scroll_bar);
+        bool shown = !ed_dst_equal(scroll_bar->committed, ed_hidden_dst);
+        if (shown != ed_is_node_visible(scroll_bar)) {
+            ed_layout(scroll_bar);
+        }
+    }
+
+    if (!(node->dirty & ED_DIRTY_LAYOUT)) {
+        return false;
+    }
+    node->dirty &= ~ED_DIRTY_LAYOUT;
+    return true;
+}
+
+// Lays out `node` and the children measured since the last layout. The tree
+// is walked in depth-first order using the sibling and parent links. Window
+// geometry is committed in one batch when the outermost call returns.
+static void
+ed_layout(ed_node *node)
+{
+    ++ed_current->layout_depth;
+
+    ed_node *n = node;
+    for (;;) {
+        if (ed_layout_node(n) && n->child) {
+            n = n->child;
+            continue;
+        }
+
+        while (n != node && !n->after) {
+            n = n->parent;
+        }
+        if (n == node) break;
+        n = n->after;
+    }
+
+    if (--ed_current->layout_depth == 0) {
+        ed_commit_geometry(node);
     }
 }
 
@@ -517,75 +1875,289 @@ static void
 ed_invalidate_scalar(ed_node *node)
 {
     char buf[64];
-    const char *fmt = node->value_fmt;
-    if (!fmt) fmt = ed_style.value_formats[node->value_type];
+    ed_node_binding *binding = ed_binding(node);
+    const char *fmt = binding->value_fmt;
+    if (!fmt) fmt = ed_style.value_formats[binding->value_type];
 
-    switch (node->value_type) {
+    switch (binding->value_type) {
     case ED_INT:
-        snprintf(buf, sizeof buf, fmt, ed_read_value(int, node->value_ptr));
+        snprintf(buf, sizeof buf, fmt, ed_read_value(int, binding->value_ptr));
         SetWindowTextA(ed_hwnd(node), buf);
         break;
     case ED_FLOAT:
-        snprintf(buf, sizeof buf, fmt, ed_read_value(float, node->value_ptr));
+        snprintf(buf, sizeof buf, fmt, ed_read_value(float, binding->value_ptr));
         SetWindowTextA(ed_hwnd(node), buf);
         break;
     case ED_INT64:
-        snprintf(buf, sizeof buf, fmt, ed_read_value(long long, node->value_ptr));
+        snprintf(buf, sizeof buf, fmt, ed_read_value(long long, binding->value_ptr));
         SetWindowTextA(ed_hwnd(node), buf);
         break;
     case ED_FLOAT64:
-        snprintf(buf, sizeof buf, fmt, ed_read_value(double, node->value_ptr));
+        snprintf(buf, sizeof buf, fmt, ed_read_value(double, binding->value_ptr));
         SetWindowTextA(ed_hwnd(node), buf);
         break;
     case ED_ENUM:
-        SendMessageA(ed_hwnd(node), CB_SETCURSEL, ed_read_value(int, node->value_ptr), 0);
+        SendMessageA(ed_hwnd(node), CB_SETCURSEL, ed_read_value(int, binding->value_ptr), 0);
         break;
     case ED_FLAGS:
         InvalidateRect(ed_hwnd(node), NULL, TRUE);
         break;
     case ED_BOOL:
-        SendMessageA(ed_hwnd(node), BM_SETCHECK, ed_read_value(bool, node->value_ptr), 0);
+        SendMessageA(ed_hwnd(node), BM_SETCHECK, ed_read_value(bool, binding->value_ptr), 0);
         break;
     default:
         assert(!"ed_invalidate_scalar expected a scalar value type.");
     }
 }
 
+// Records the address range of the value of a node for ed_notify_range.
+//
+// size:
+//   Size of the value, 0 for a string whose buffer size is unknown.
+static void
+ed_range_set(ed_node *node, const void *value, size_t size)
+{
+    struct ed_range_index *index = &ed_current->ranges;
+    ed_node_binding *binding = ed_binding(node);
+
+    if (!size) {
+        size = binding->value_type == ED_STRING ? strlen((const char *)value) + 1 : 1;
+    }
+
+    UINT_PTR begin = (UINT_PTR)value;
+    UINT_PTR end = begin + size;
+
+    if (binding->range_slot) {
+        struct ed_range *range = &index->ranges[binding->range_slot - 1];
+        if (range->begin != begin) {
+            index->sorted = false;
+        } else if (range->end != end) {
+            index->max_end_valid = false;
+        }
+        range->begin = begin;
+        range->end = end;
+        return;
+    }
+
+    if (index->count == index->capacity) {
+        unsigned capacity = ed_max(2 * index->capacity, 64);
+        struct ed_range *ranges = (struct ed_range *)realloc(
+                index->ranges, capacity * sizeof(struct ed_range));
+        UINT_PTR *max_end = (UINT_PTR *)realloc(index->max_end, capacity * sizeof(UINT_PTR));
+        assert(ranges && max_end && "out of memory.");
+
+        index->ranges = ranges;
+        index->max_end = max_end;
+        index->capacity = capacity;
+    }
+
+    struct ed_range range = {begin, end, node->id};
+    index->ranges[index->count] = range;
+    binding->range_slot = ++index->count;
+    index->sorted = false;
+}
+
+static int
+ed_range_compare(const void *a, const void *b)
+{
+    UINT_PTR x = ((const struct ed_range *)a)->begin;
+    UINT_PTR y = ((const struct ed_range *)b)->begin;
+    return (x > y) - (x < y);
+}
+
+// Computes `max_end` of the subtree of ranges from `first` to `last`, rooted
+// at the middle range.
+static UINT_PTR
+ed_range_build(struct ed_range_index *index, unsigned first, unsigned last)
+{
+    if (first >= last) {
+        return 0;
+    }
+
+    unsigned mid = first + (last - first) / 2;
+    UINT_PTR max_end = index->ranges[mid].end;
+    UINT_PTR left = ed_range_build(index, first, mid);
+    UINT_PTR right = ed_range_build(index, mid + 1, last);
+    max_end = ed_max(max_end, ed_max(left, right));
+    index->max_end[mid] = max_end;
+    return max_end;
+}
+
+static void
+ed_range_mark(struct ed_range_index *index, int id)
+{
+    ed_node *node = ed_index_node(id);
+    if (node->flags & ED_DATAPENDING) {
+        return;
+    }
+
+    if (index->pending_count == index->pending_capacity) {
+        unsigned capacity = ed_max(2 * index->pending_capacity, 64);
+        int *pending = (int *)realloc(index->pending, capacity * sizeof(int));
+        assert(pending && "out of memory.");
+
+        index->pending = pending;
+        index->pending_capacity = capacity;
+    }
+
+    node->flags |= ED_DATAPENDING;
+    index->pending[index->pending_count++] = id;
+}
+
+// Marks the ranges from `first` to `last` overlapping `begin` to `end`. Left
+// subtrees ending before `begin` and right subtrees starting after `end` are
+// skipped, so only O(log n) ranges are visited besides the overlapping ones.
+static void
+ed_range_query(struct ed_range_index *index, unsigned first, unsigned last,
+        UINT_PTR begin, UINT_PTR end)
+{
+    while (first < last) {
+        unsigned mid = first + (last - first) / 2;
+        if (index->max_end[mid] <= begin) {
+            return;
+        }
+
+        ed_range_query(index, first, mid, begin, end);
+
+        const struct ed_range *range = &index->ranges[mid];
+        if (range->begin >= end) {
+            return;
+        }
+        if (range->end > begin) {
+            ed_range_mark(index, range->id);
+        }
+        first = mid + 1;
+    }
+}
+
+// Refreshes the nodes marked by ed_notify_range from their value.
+static void
+ed_range_refresh(void)
+{
+    struct ed_range_index *index = &ed_current->ranges;
+    ed_current->stats->notify_refreshed = 0;
+
+    if (!index->pending_count) {
+        return;
+    }
+
+    ed_node *focus = ed_get_focus();
+
+    for (unsigned i = 0; i < index->pending_count; ++i) {
+        ed_node *node = ed_index_node(index->pending[i]);
+        node->flags &= ~ED_DATAPENDING;
+        if (node == focus) {
+            // Keep the text being edited.
+            continue;
+        }
+
+        ed_node_binding *binding = ed_binding(node);
+        if (binding->value_type != ED_STRING) {
+            memcpy(binding->value, binding->value_ptr,
+                    ed_min(binding->value_size, sizeof binding->value));
+        }
+        ed_invalidate_data(node);
+        ++ed_current->stats->notify_refreshed;
+    }
+
+    index->pending_count = 0;
+}
+
+// Marks every node whose value, as last passed to `ed_data` or `ed_bind`,
+// overlaps the given range of memory. The marked nodes are refreshed by the
+// next call to `ed_update`, without comparing their values.
+//
+//     memcpy(components, simulation, 64 * sizeof(component));
+//     ed_notify_range(components, 64 * sizeof(component));
+//
+// Each element of a `node_list` has its own range, so only the overlapping
+// elements of a vector or matrix are refreshed.
+void
+ed_notify_range(const void *data, size_t size)
+{
+    struct ed_range_index *index = &ed_current->ranges;
+
+    if (!index->sorted) {
+        qsort(index->ranges, index->count, sizeof(struct ed_range), ed_range_compare);
+        for (unsigned i = 0; i < index->count; ++i) {
+            ed_binding(ed_index_node(index->ranges[i].id))->range_slot = i + 1;
+        }
+        index->sorted = true;
+        index->max_end_valid = false;
+    }
+    if (!index->max_end_valid) {
+        ed_range_build(index, 0, index->count);
+        index->max_end_valid = true;
+    }
+
+    UINT_PTR begin = (UINT_PTR)data;
+    ed_range_query(index, 0, index->count, begin, begin + size);
+}
+
+// FNV-1a hash of a string of at most `max_count` characters, or of any length
+// if `max_count` is 0. The length is returned in `length`.
+static unsigned long long
+ed_hash_text(const char *text, size_t max_count, size_t *length)
+{
+    unsigned long long hash = 14695981039346656037ull;
+    size_t i = 0;
+    for (; (!max_count || i < max_count) && text[i]; ++i) {
+        hash = (hash ^ (unsigned char)text[i]) * 1099511628211ull;
+    }
+    *length = i;
+    return hash;
+}
+
+// Records the text set on the window of a string node, so ed_data_string
+// detects changes without reading the text back.
+static void
+ed_set_text_hash(ed_node_binding *binding)
+{
+    size_t length;
+    binding->text_hash = ed_hash_text((const char *)binding->value_ptr,
+            binding->value_size, &length);
+    binding->text_length = length + 1;
+}
+
 static void
 ed_data_string(ed_node *node, void *value, size_t size)
 {
+    ed_node_binding *binding = ed_binding(node);
+
     if (ed_get_focus() == node || !ed_is_visible(node)) {
-        node->value_size = size;
-        node->value_ptr = value;
+        if (value != binding->value_ptr || size != binding->value_size) {
+            ed_range_set(node, value, size);
+        }
+        binding->value_size = size;
+        binding->value_ptr = value;
         return;
     }
 
-    if (value == node->value_ptr && size == node->value_size) {
-        int text_size = GetWindowTextLengthA(ed_hwnd(node)) + 1;
-        char *text = (char *)_malloca(text_size);
-        GetWindowTextA(ed_hwnd(node), text, text_size);
+    size_t length;
+    unsigned long long hash = ed_hash_text((const char *)value, size, &length);
 
-        size_t max_count = node->value_size ? node->value_size : text_size;
-        if (!strncmp(text, (char *)value, max_count)) {
-            // No change to string, avoid redraw.
-            _freea(text);
-            return;
-        }
-
-        _freea(text);
+    if (value == binding->value_ptr && size == binding->value_size
+            && binding->text_length == length + 1 && binding->text_hash == hash) {
+        // No change to string, avoid redraw.
+        return;
     }
 
-    node->value_size = size;
-    node->value_ptr = value;
+    binding->value_size = size;
+    binding->value_ptr = value;
+    binding->text_hash = hash;
+    binding->text_length = length + 1;
+    ed_range_set(node, value, size);
 
-    SetWindowTextA(ed_hwnd(node), (char *)node->value_ptr);
+    SetWindowTextA(ed_hwnd(node), (char *)binding->value_ptr);
 }
 
 static void
 ed_data_scalar(ed_node *node, void *value, size_t size)
 {
+    ed_node_binding *binding = ed_binding(node);
+
     if (size == 0) {
-        switch (node->value_type) {
+        switch (binding->value_type) {
         case ED_INT:   size = sizeof(int); break;
         case ED_FLOAT: size = sizeof(float); break;
         case ED_INT64: size = sizeof(long long); break;
@@ -596,21 +2168,22 @@ ed_data_scalar(ed_node *node, void *value, size_t size)
         }
     }
 
-    if (value == node->value_ptr
-            && size == node->value_size
-            && !memcmp(node->value, value, node->value_size)) {
+    if (value == binding->value_ptr
+            && size == binding->value_size
+            && !memcmp(binding->value, value, binding->value_size)) {
         // No change to value.
         return;
     }
 
-    node->value_size = size;
-    node->value_ptr = value;
+    binding->value_size = size;
+    binding->value_ptr = value;
+    ed_range_set(node, value, size);
 
     if (ed_get_focus() == node || !ed_is_visible(node)) {
         return;
     }
 
-    memcpy(&node->value, value, node->value_size);
+    memcpy(&binding->value, value, binding->value_size);
     ed_invalidate_scalar(node);
 }
 
@@ -630,18 +2203,21 @@ ed_data_color(ed_node *node, void *value, size_t size)
         size = 4 * sizeof(float);
     }
 
-    if (value == node->value_ptr
-            && size == node->value_size
-            && !memcmp(node->value, value, node->value_size)) {
+    ed_node_binding *binding = ed_binding(node);
+
+    if (value == binding->value_ptr
+            && size == binding->value_size
+            && !memcmp(binding->value, value, binding->value_size)) {
         // No change to value.
         return;
     }
 
-    node->value_size = size;
-    node->value_ptr = value;
+    binding->value_size = size;
+    binding->value_ptr = value;
+    ed_range_set(node, value, size);
 
     if (ed_get_focus() != node && ed_is_visible(node)) {
-        memcpy(&node->value, value, node->value_size);
+        memcpy(&binding->value, value, binding->value_size);
         InvalidateRect(ed_hwnd(node), NULL, TRUE);
     }
 }
@@ -650,13 +2226,21 @@ static void
 ed_set_scroll_position(ed_node *client, int y)
 {
     ed_node *scrollbar = ed_index_node(client->scroll_bar);
-    if (ed_is_visible(scrollbar)) {
-        SetScrollPos(ed_hwnd(scrollbar), SB_CTL, y, TRUE);
-
-        // Get scroll position again, SetScrollPos might have clamped it.
-        y = GetScrollPos(ed_hwnd(scrollbar), SB_CTL);
-        ScrollWindow(ed_hwnd(client), 0, client->scroll_pos - y, NULL, NULL);
-        client->scroll_pos = (short)y;
+    if (client->flags & ED_OVERFLOW) {
+        // Clamp in pixels, the native scrollbar only holds a scaled position.
+        int extent = ed_scroll_extent(client);
+        int max_scroll_pos = ed_max(extent - client->dst.h, 0);
+        y = ed_clamp(y, 0, max_scroll_pos);
+
+        SetScrollPos(ed_hwnd(scrollbar), SB_CTL, y / ed_scroll_scale(extent), TRUE);
+        ed_binding(scrollbar)->committed_scroll[2] = y;
+        if (client->flags & ED_VIRTUALLIST) {
+            ed_binding(client)->list->scroll = y;
+            ed_list_refresh(client, false);
+        } else {
+            ScrollWindow(ed_hwnd(client), 0, client->scroll_pos - y, NULL, NULL);
+            client->scroll_pos = y;
+        }
     }
 }
 
@@ -668,7 +2252,7 @@ ed_next_tabstop(ed_node *node)
         node = ed_find_node_with_flags_ordered(node, ED_TABSTOP, true);
         if (!node && !wrapped) {
             // Cycle to first tabstop.
-            node = ed_find_node_with_flags(ed_index_node(ED_ID_ROOT), ED_TABSTOP, false);
+            node = ed_find_node_with_flags(ED_ID_ROOT, ED_TABSTOP);
             wrapped = true;
         }
     } while (node && (!ed_is_visible(node) || !ed_is_enabled(node)));
@@ -684,8 +2268,7 @@ ed_previous_tabstop(ed_node *node)
         node = ed_rfind_node_with_flags_ordered(node, ED_TABSTOP, true);
         if (!node && !wrapped) {
             // Cycle to last tabstop.
-            node = ed_rfind_node_with_flags(
-                    ed_index_node((short)used_node_count), ED_TABSTOP, false);
+            node = ed_rfind_node_with_flags(-1, ED_TABSTOP);
             wrapped = true;
         }
     } while (node && (!ed_is_visible(node) || !ed_is_enabled(node)));
@@ -772,13 +2355,15 @@ ed_load_image(ed_node *node, const char *filename)
     int h = (int)node->rect.h;
     const char *ext = ed_file_extension(filename);
 
+    ed_node_binding *binding = ed_binding(node);
+
     if (!strcmp(ext, "ico")) {
-        node->value_ptr = ed_load_icon(filename, &w, &h);
-        node->value_type = ED_ICON;
+        binding->value_ptr = ed_load_icon(filename, &w, &h);
+        binding->value_type = ED_ICON;
     } else {
         // Assume bitmap file
-        node->value_ptr = ed_load_bitmap(filename, &w, &h);
-        node->value_type = ED_BITMAP;
+        binding->value_ptr = ed_load_bitmap(filename, &w, &h);
+        binding->value_type = ED_BITMAP;
     }
 
     node->rect.w = (float)w;
@@ -793,7 +2378,8 @@ ed_alloc_bitmap_buffer(ed_node *node,
     buffer.fmt = fmt;
     buffer.w = (short)ed_abs(w);
     buffer.h = (short)ed_abs(h);
-    ed_write_value(ed_bitmap_buffer, node->value, &buffer);
+    ed_node_binding *binding = ed_binding(node);
+    ed_write_value(ed_bitmap_buffer, binding->value, &buffer);
 
     BITMAPINFO bmi = {0};
     bmi.bmiHeader.biSize        = sizeof(bmi.bmiHeader);
@@ -805,13 +2391,13 @@ ed_alloc_bitmap_buffer(ed_node *node,
     bmi.bmiHeader.biSizeImage   = buffer.w * buffer.h * ED_BITMAP_BYTESPERPIXEL;
 
     HDC hdc = GetDC(ed_hwnd(node));
-    node->value_ptr = CreateDIBSection(hdc, &bmi, DIB_RGB_COLORS,
-            (void **)&node->value_dib_image, NULL, 0);
+    binding->value_ptr = CreateDIBSection(hdc, &bmi, DIB_RGB_COLORS,
+            (void **)&binding->value_dib_image, NULL, 0);
 
     if (image) {
         ed_image_buffer_copy(node, image);
     } else {
-        memset(node->value_dib_image, 0, bmi.bmiHeader.biSizeImage);
+        memset(binding->value_dib_image, 0, bmi.bmiHeader.biSizeImage);
     }
 
     ReleaseDC(ed_hwnd(node), hdc);
@@ -885,9 +2471,9 @@ ed_update_color_picker_slice(void)
     float rgb[3];
     float hsv[3];
 
-    hsv[0] = color_picker.hsv[0];
-    ed_bitmap_buffer buffer = ed_read_value(ed_bitmap_buffer, color_picker.slice->value);
-    unsigned int *dst = (unsigned int *)color_picker.slice->value_dib_image;
+    hsv[0] = ed_current->color_picker.hsv[0];
+    ed_bitmap_buffer buffer = ed_read_value(ed_bitmap_buffer, ed_binding(ed_current->color_picker.slice)->value);
+    unsigned int *dst = (unsigned int *)ed_binding(ed_current->color_picker.slice)->value_dib_image;
 
     float one_over_w = 1.0f / buffer.w;
     float one_over_h = 1.0f / buffer.h;
@@ -910,8 +2496,8 @@ ed_init_color_picker_hue(void)
 
     hsv[1] = 1.0f;
     hsv[2] = 1.0f;
-    ed_bitmap_buffer buffer = ed_read_value(ed_bitmap_buffer, color_picker.hue->value);
-    unsigned int *dst = (unsigned int *)color_picker.hue->value_dib_image;
+    ed_bitmap_buffer buffer = ed_read_value(ed_bitmap_buffer, ed_binding(ed_current->color_picker.hue)->value);
+    unsigned int *dst = (unsigned int *)ed_binding(ed_current->color_picker.hue)->value_dib_image;
 
     assert(ed_min(buffer.w, buffer.h) == 1);
     short size = ed_max(buffer.w, buffer.h);
@@ -929,37 +2515,39 @@ ed_color_picker_rgba_on_change(ed_node *node)
 {
     (void)node;
 
-    ed_hsv_from_rgb(color_picker.hsv, color_picker.rgba);
+    ed_hsv_from_rgb(ed_current->color_picker.hsv, ed_current->color_picker.rgba);
     ed_update_color_picker_slice();
-    InvalidateRect(ed_hwnd(color_picker.hue), NULL, FALSE);
-    InvalidateRect(ed_hwnd(color_picker.slice), NULL, FALSE);
-    InvalidateRect(ed_hwnd(color_picker.node), NULL, FALSE);
-    color_picker.rgb_packed = ed_pack_rgb(color_picker.rgba);
-    ed_data(color_picker.rgb_hex, &color_picker.rgb_packed);
+    InvalidateRect(ed_hwnd(ed_current->color_picker.hue), NULL, FALSE);
+    InvalidateRect(ed_hwnd(ed_current->color_picker.slice), NULL, FALSE);
+    InvalidateRect(ed_hwnd(ed_current->color_picker.node), NULL, FALSE);
+    ed_current->color_picker.rgb_packed = ed_pack_rgb(ed_current->color_picker.rgba);
+    ed_data(ed_current->color_picker.rgb_hex, &ed_current->color_picker.rgb_packed);
 }
 
 static void
 ed_color_picker_hex_on_change(ed_node *node)
 {
-    if (!node->value_ptr || !color_picker.rgba) return;
-    int change = ed_read_value(int, node->value);
+    ed_node_binding *binding = ed_binding(node);
+
+    if (!binding->value_ptr || !ed_current->color_picker.rgba) return;
+    int change = ed_read_value(int, binding->value);
 
     if (change < 0 || change > 0xFFFFFF) {
-        ed_write_value(int, node->value, node->value_ptr);
+        ed_write_value(int, binding->value, binding->value_ptr);
         return;
     }
 
     const float one_over_255 = 1.0f / 255.0f;
-    color_picker.rgba[0] = ((change >> 16) & 0xFF) * one_over_255;
-    color_picker.rgba[1] = ((change >> 8)  & 0xFF) * one_over_255;
-    color_picker.rgba[2] = ((change >> 0)  & 0xFF) * one_over_255;
-    ed_data(color_picker.rgba_slider, color_picker.rgba);
+    ed_current->color_picker.rgba[0] = ((change >> 16) & 0xFF) * one_over_255;
+    ed_current->color_picker.rgba[1] = ((change >> 8)  & 0xFF) * one_over_255;
+    ed_current->color_picker.rgba[2] = ((change >> 0)  & 0xFF) * one_over_255;
+    ed_data(ed_current->color_picker.rgba_slider, ed_current->color_picker.rgba);
 
-    ed_hsv_from_rgb(color_picker.hsv, color_picker.rgba);
+    ed_hsv_from_rgb(ed_current->color_picker.hsv, ed_current->color_picker.rgba);
     ed_update_color_picker_slice();
-    InvalidateRect(ed_hwnd(color_picker.hue), NULL, FALSE);
-    InvalidateRect(ed_hwnd(color_picker.slice), NULL, FALSE);
-    InvalidateRect(ed_hwnd(color_picker.node), NULL, FALSE);
+    InvalidateRect(ed_hwnd(ed_current->color_picker.hue), NULL, FALSE);
+    InvalidateRect(ed_hwnd(ed_current->color_picker.slice), NULL, FALSE);
+    InvalidateRect(ed_hwnd(ed_current->color_picker.node), NULL, FALSE);
 }
 
 static void
@@ -967,16 +2555,16 @@ ed_color_picker_revert(ed_node *node)
 {
     (void)node;
 
-    memcpy(color_picker.rgba, color_picker.original_color, 4 * sizeof(float));
-    color_picker.rgb_packed = ed_pack_rgb(color_picker.rgba);
-    ed_hsv_from_rgb(color_picker.hsv, color_picker.rgba);
+    memcpy(ed_current->color_picker.rgba, ed_current->color_picker.original_color, 4 * sizeof(float));
+    ed_current->color_picker.rgb_packed = ed_pack_rgb(ed_current->color_picker.rgba);
+    ed_hsv_from_rgb(ed_current->color_picker.hsv, ed_current->color_picker.rgba);
     ed_update_color_picker_slice();
 
-    ed_data(color_picker.rgb_hex, &color_picker.rgb_packed);
-    ed_data(color_picker.rgba_slider, color_picker.rgba);
-    InvalidateRect(ed_hwnd(color_picker.hue), NULL, FALSE);
-    InvalidateRect(ed_hwnd(color_picker.slice), NULL, FALSE);
-    InvalidateRect(ed_hwnd(color_picker.node), NULL, FALSE);
+    ed_data(ed_current->color_picker.rgb_hex, &ed_current->color_picker.rgb_packed);
+    ed_data(ed_current->color_picker.rgba_slider, ed_current->color_picker.rgba);
+    InvalidateRect(ed_hwnd(ed_current->color_picker.hue), NULL, FALSE);
+    InvalidateRect(ed_hwnd(ed_current->color_picker.slice), NULL, FALSE);
+    InvalidateRect(ed_hwnd(ed_current->color_picker.node), NULL, FALSE);
 }
 
 static void
@@ -992,7 +2580,8 @@ ed_open_color_picker(ed_node *node)
             ed_push_rect(0, 0, 1, ed_style.input_height);              \
             input = ed_float(NULL, 0, 1);                              \
             input->spacing = 0;                                        \
-            input->onchange = ed_color_picker_rgba_on_change;          \
+            ed_binding(input)->onchange =                              \
+                ed_color_picker_rgba_on_change;                        \
         }                                                              \
         ed_end();                                                      \
     }
@@ -1003,7 +2592,7 @@ ed_open_color_picker(ed_node *node)
     RECT node_rect;
     GetWindowRect(ed_hwnd(node), &node_rect);
 
-    if (!color_picker.dialog || color_picker.dialog->type == ED_NONE) {
+    if (!ed_current->color_picker.dialog || ed_current->color_picker.dialog->type == ED_NONE) {
         HWND hwnd = CreateWindowA("ED_USERWINDOW", "Color Picker",
                 WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU | WS_VISIBLE,
                 node_rect.right - rect.right, node_rect.top + node->dst.h,
@@ -1011,24 +2600,24 @@ ed_open_color_picker(ed_node *node)
                 NULL, NULL, GetModuleHandleA(NULL), NULL);
 
         ed_begin_context(ed_index_node(ED_ID_ROOT));
-        color_picker.dialog = ed_begin_hwnd(hwnd, ED_VERT);
+        ed_current->color_picker.dialog = ed_begin_hwnd(hwnd, ED_VERT);
         {
             ed_begin(ED_HORZ, 0, 0, 280, 256);
             {
-                color_picker.hue = ed_attach(ED_IMAGE, 0, 0, 24, 256);
-                ed_attach_hwnd(color_picker.hue, "ED_COLOR_HUE",
+                ed_current->color_picker.hue = ed_attach(ED_IMAGE, 0, 0, 24, 256);
+                ed_attach_hwnd(ed_current->color_picker.hue, "ED_COLOR_HUE",
                         NULL, WS_CHILD | WS_VISIBLE);
-                color_picker.hue->value_type = ED_DIB;
-                color_picker.hue->flags = ED_OWNDATA;
-                ed_alloc_bitmap_buffer(color_picker.hue, NULL, 1, 256, ED_BGRA);
+                ed_binding(ed_current->color_picker.hue)->value_type = ED_DIB;
+                ed_current->color_picker.hue->flags = ED_OWNDATA;
+                ed_alloc_bitmap_buffer(ed_current->color_picker.hue, NULL, 1, 256, ED_BGRA);
                 ed_init_color_picker_hue();
 
-                color_picker.slice = ed_attach(ED_IMAGE, 0, 0, 256, 256);
-                ed_attach_hwnd(color_picker.slice, "ED_COLOR_SLICE",
+                ed_current->color_picker.slice = ed_attach(ED_IMAGE, 0, 0, 256, 256);
+                ed_attach_hwnd(ed_current->color_picker.slice, "ED_COLOR_SLICE",
                         NULL, WS_CHILD | WS_VISIBLE);
-                color_picker.slice->value_type = ED_DIB;
-                color_picker.slice->flags = ED_OWNDATA;
-                ed_alloc_bitmap_buffer(color_picker.slice, NULL, 256, 256, ED_BGRA);
+                ed_binding(ed_current->color_picker.slice)->value_type = ED_DIB;
+                ed_current->color_picker.slice->flags = ED_OWNDATA;
+                ed_alloc_bitmap_buffer(ed_current->color_picker.slice, NULL, 256, 256, ED_BGRA);
             }
             ed_end();
 
@@ -1040,24 +2629,24 @@ ed_open_color_picker(ed_node *node)
                 color_rgba(b_node, "B");
                 color_rgba(a_node, "A");
 
-                r_node->node_list = g_node;
-                g_node->node_list = b_node;
-                b_node->node_list = a_node;
-                color_picker.rgba_slider = r_node;
+                ed_binding(r_node)->node_list = g_node;
+                ed_binding(g_node)->node_list = b_node;
+                ed_binding(b_node)->node_list = a_node;
+                ed_current->color_picker.rgba_slider = r_node;
 
                 ed_begin(ED_HORZ, 1, 0, 160, 0)->spacing = ed_style.spacing / 2;
                 {
                     ed_push_rect(0, 0, 0, 24);
                     ed_node *revert = ed_button("Revert", NULL);
-                    revert->onclick = ed_color_picker_revert;
+                    ed_binding(revert)->onclick = ed_color_picker_revert;
 
                     ed_push_rect(0, 0, 12, 24);
                     ed_label("#")->spacing = 0;
 
                     ed_push_rect(0, 0, 1, 24);
-                    color_picker.rgb_hex = ed_int_fmt(NULL, 0, 0, "%06X", 16);
-                    color_picker.rgb_hex->spacing = 0;
-                    color_picker.rgb_hex->onchange = ed_color_picker_hex_on_change;
+                    ed_current->color_picker.rgb_hex = ed_int_fmt(NULL, 0, 0, "%06X", 16);
+                    ed_current->color_picker.rgb_hex->spacing = 0;
+                    ed_binding(ed_current->color_picker.rgb_hex)->onchange = ed_color_picker_hex_on_change;
                 }
                 ed_end();
             }
@@ -1066,26 +2655,26 @@ ed_open_color_picker(ed_node *node)
         ed_end();
         ed_end_context();
     } else {
-        SetWindowPos(ed_hwnd(color_picker.dialog), NULL,
+        SetWindowPos(ed_hwnd(ed_current->color_picker.dialog), NULL,
                 node_rect.right - rect.right,
                 node_rect.top + node->dst.h, 0, 0,
                 SWP_NOZORDER | SWP_NOOWNERZORDER
                 | SWP_NOREDRAW | SWP_NOSIZE);
 
-        ShowWindow(ed_hwnd(color_picker.dialog), SW_SHOW);
+        ed_show(ed_current->color_picker.dialog);
     }
 
-    assert(node->value_ptr);
-    color_picker.node = node;
-    color_picker.rgba = (float *)node->value_ptr;
-    color_picker.rgb_packed = ed_pack_rgb(color_picker.rgba);
-    memcpy(color_picker.original_color, color_picker.rgba, 4 * sizeof(float));
+    assert(ed_binding(node)->value_ptr);
+    ed_current->color_picker.node = node;
+    ed_current->color_picker.rgba = (float *)ed_binding(node)->value_ptr;
+    ed_current->color_picker.rgb_packed = ed_pack_rgb(ed_current->color_picker.rgba);
+    memcpy(ed_current->color_picker.original_color, ed_current->color_picker.rgba, 4 * sizeof(float));
 
-    ed_hsv_from_rgb(color_picker.hsv, color_picker.rgba);
+    ed_hsv_from_rgb(ed_current->color_picker.hsv, ed_current->color_picker.rgba);
     ed_update_color_picker_slice();
-    ed_data(color_picker.rgba_slider, color_picker.rgba);
-    ed_data(color_picker.rgb_hex, &color_picker.rgb_packed);
-    ed_invalidate(color_picker.dialog);
+    ed_data(ed_current->color_picker.rgba_slider, ed_current->color_picker.rgba);
+    ed_data(ed_current->color_picker.rgb_hex, &ed_current->color_picker.rgb_packed);
+    ed_invalidate(ed_current->color_picker.dialog);
 }
 
 static LRESULT __stdcall
@@ -1097,16 +2686,15 @@ ed_window_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
     case WM_DRAWITEM: {
         DRAWITEMSTRUCT *dis = (DRAWITEMSTRUCT *)lparam;
         if (dis->CtlType == ODT_COMBOBOX) {
-            assert(wparam);
-            ed_node *item = ed_index_node((short)wparam);
+            ed_node *item = (ed_node *)GetWindowLongPtrA(dis->hwndItem, GWLP_USERDATA);
             assert(item->type == ED_COMBOBOX);
 
-            SelectObject(dis->hDC, ui_font);
+            SelectObject(dis->hDC, ed_current->ui_font);
             SetTextColor(dis->hDC, ed_style.colors[ED_COLOR_WINDOWTEXT]);
             SetBkColor(dis->hDC, ed_style.colors[ED_COLOR_WINDOW]);
 
-            if (item->value_type == ED_FLAGS) {
-                unsigned long long value = *(unsigned long long *)&item->value;
+            if (ed_binding(item)->value_type == ED_FLAGS) {
+                unsigned long long value = *(unsigned long long *)&ed_binding(item)->value;
                 if (dis->itemState & ODS_COMBOBOXEDIT) {
                     // This is the value shown above the dropdown.
                     char buf[19] = {0};
@@ -1146,9 +2734,9 @@ ed_window_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
         HDC hdc = BeginPaint(hwnd, &ps);
         RECT rect;
         GetClientRect(hwnd, &rect);
-        FillRect(hdc, &rect, brushes[ED_COLOR_3DFACE]);
+        FillRect(hdc, &rect, ed_current->brushes[ED_COLOR_3DFACE]);
         if (node && (node->flags & ED_BORDER)) {
-            FrameRect(hdc, &rect, brushes[ED_COLOR_GRAYTEXT]);
+            FrameRect(hdc, &rect, ed_current->brushes[ED_COLOR_GRAYTEXT]);
         }
         EndPaint(hwnd, &ps);
         return 1;
@@ -1161,7 +2749,7 @@ ed_window_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
 
             int delta = (GET_WHEEL_DELTA_WPARAM(wparam) / WHEEL_DELTA) * scroll_lines;
             ed_set_scroll_position(client,
-                    client->scroll_pos - delta * ed_style.scroll_sensitivity);
+                    ed_scroll_offset(client) - delta * ed_style.scroll_sensitivity);
             return 1;
         }
         break;
@@ -1169,13 +2757,21 @@ ed_window_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
     case WM_VSCROLL: {
         if (node && node->type == ED_SCROLLBLOCK) {
             ed_node *client = node->child;
-            short scroll_pos = client->scroll_pos;
+            int scroll_pos = ed_scroll_offset(client);
 
             switch (LOWORD(wparam)) {
-            case SB_LINEUP:        scroll_pos -= ed_style.scroll_unit; break;
-            case SB_LINEDOWN:      scroll_pos += ed_style.scroll_unit; break;
-            case SB_THUMBPOSITION: scroll_pos = HIWORD(wparam); break;
-            case SB_THUMBTRACK:    scroll_pos = HIWORD(wparam); break;
+            case SB_LINEUP:   scroll_pos -= ed_style.scroll_unit; break;
+            case SB_LINEDOWN: scroll_pos += ed_style.scroll_unit; break;
+            case SB_THUMBPOSITION:
+            case SB_THUMBTRACK: {
+                // The position in wparam is limited to 16 bits.
+                SCROLLINFO si = {0};
+                si.cbSize = sizeof(si);
+                si.fMask = SIF_TRACKPOS;
+                GetScrollInfo((HWND)lparam, SB_CTL, &si);
+                scroll_pos = si.nTrackPos * ed_scroll_scale(ed_scroll_extent(client));
+                break;
+            }
             }
             ed_set_scroll_position(client, scroll_pos);
             return 1;
@@ -1187,39 +2783,41 @@ ed_window_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
 
         switch (HIWORD(wparam)) {
         case CBN_SELCHANGE: {
+            ed_node_binding *binding = ed_binding(c);
             int selected = (int)SendMessageA(ed_hwnd(c), CB_GETCURSEL, 0, 0);
-            if (c->value_ptr && selected != -1) {
-                if (c->value_type == ED_ENUM) {
-                    ed_write_value(int, c->value, &selected);
-                } else if (c->value_type == ED_FLAGS) {
+            if (binding->value_ptr && selected != -1) {
+                if (binding->value_type == ED_ENUM) {
+                    ed_write_value(int, binding->value, &selected);
+                } else if (binding->value_type == ED_FLAGS) {
                     assert(selected < 64);
                     unsigned long long value = ed_read_value(unsigned long long,
-                            &c->value);
+                            &binding->value);
                     value ^= 1ULL << selected;
-                    ed_write_value(unsigned long long, c->value, &value);
+                    ed_write_value(unsigned long long, binding->value, &value);
                     InvalidateRect(ed_hwnd(c), NULL, FALSE);
                 }
 
-                if (c->onchange) c->onchange(c);
-                memcpy(c->value_ptr, &c->value, c->value_size);
+                if (binding->onchange) binding->onchange(c);
+                memcpy(binding->value_ptr, &binding->value, binding->value_size);
             }
             break;
         }
         case BN_CLICKED: {
-            if (c->type == ED_CHECKBOX && c->value_ptr) {
+            ed_node_binding *binding = ed_binding(c);
+            if (c->type == ED_CHECKBOX && binding->value_ptr) {
                 int state = (int)SendMessageA(ed_hwnd(c), BM_GETCHECK, 0, 0);
 
                 // Call ed_data to initialize the node.
                 assert(state != BST_INDETERMINATE);
 
                 bool current_value = !(state == BST_CHECKED);
-                ed_write_value(bool, c->value, &current_value);
+                ed_write_value(bool, binding->value, &current_value);
 
-                if (c->onchange) c->onchange(c);
-                memcpy(c->value_ptr, c->value, c->value_size);
+                if (binding->onchange) binding->onchange(c);
+                memcpy(binding->value_ptr, binding->value, binding->value_size);
                 SendMessageA(ed_hwnd(c), BM_SETCHECK, current_value, 0);
             } else if (c->type == ED_BUTTON) {
-                if (c->onclick) c->onclick(c);
+                if (binding->onclick) binding->onclick(c);
             }
             break;
         }
@@ -1252,7 +2850,7 @@ ed_user_window_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
     case WM_PAINT: {
         PAINTSTRUCT ps;
         HDC hdc = BeginPaint(hwnd, &ps);
-        FillRect(hdc, &ps.rcPaint, brushes[ED_COLOR_WINDOW]);
+        FillRect(hdc, &ps.rcPaint, ed_current->brushes[ED_COLOR_WINDOW]);
         EndPaint(hwnd, &ps);
         break;
     }
@@ -1283,14 +2881,14 @@ ed_caption_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
         SetBkMode(hdc, TRANSPARENT);
         RECT rect;
         GetClientRect(hwnd, &rect);
-        FillRect(hdc, &rect, brushes[ED_COLOR_HIGHLIGHT]);
+        FillRect(hdc, &rect, ed_current->brushes[ED_COLOR_HIGHLIGHT]);
 
         if (GetFocus() == hwnd) {
-            FrameRect(hdc, &rect, brushes[ED_COLOR_WINDOWTEXT]);
+            FrameRect(hdc, &rect, ed_current->brushes[ED_COLOR_WINDOWTEXT]);
         }
         rect.left += ed_style.spacing;
 
-        SelectObject(hdc, ui_font);
+        SelectObject(hdc, ed_current->ui_font);
         SetTextColor(hdc, ed_style.colors[ED_COLOR_HIGHLIGHTTEXT]);
         if (p && (p->flags & ED_EXPAND)) {
             if (p->flags & ED_COLLAPSED) {
@@ -1314,6 +2912,7 @@ ed_caption_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
             p->flags ^= ED_COLLAPSED;
 
             // Node size changed, parent may need to reflow
+            ed_mark_dirty(p);
             ed_invalidate(p->parent);
         }
         break;
@@ -1332,15 +2931,15 @@ ed_image_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
     case WM_NCHITTEST:
         return HTTRANSPARENT;
     case WM_PAINT:
-        if (node && node->value_ptr) {
+        if (node && ed_binding(node)->value_ptr) {
             PAINTSTRUCT ps;
             HDC hdc_dst = BeginPaint(hwnd, &ps);
             RECT rect;
             GetClientRect(ed_hwnd(node), &rect);
 
             HDC hdc = CreateCompatibleDC(hdc_dst);
-            SelectObject(hdc, (HBITMAP)node->value_ptr);
-            ed_bitmap_buffer buffer = ed_read_value(ed_bitmap_buffer, node->value);
+            SelectObject(hdc, (HBITMAP)ed_binding(node)->value_ptr);
+            ed_bitmap_buffer buffer = ed_read_value(ed_bitmap_buffer, ed_binding(node)->value);
 
             BLENDFUNCTION blendfn;
             blendfn.BlendOp = AC_SRC_OVER;
@@ -1380,7 +2979,7 @@ ed_color_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
 
     switch (msg) {
     case WM_LBUTTONUP: {
-        if (node && node->value_ptr) {
+        if (node && ed_binding(node)->value_ptr) {
             ed_open_color_picker(node);
             return 1;
         }
@@ -1395,7 +2994,7 @@ ed_color_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
         DrawEdge(hdc, &rect, BDR_SUNKEN, BF_RECT);
         InflateRect(&rect, -2, -2);
 
-        float *rgba = (float *)node->value_ptr;
+        float *rgba = (float *)ed_binding(node)->value_ptr;
         if (rgba) {
             unsigned char r = (unsigned char)(rgba[0] * 255.0f);
             unsigned char g = (unsigned char)(rgba[1] * 255.0f);
@@ -1427,22 +3026,22 @@ ed_color_slice_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
     }
     case WM_MOUSEMOVE: {
         if (GetKeyState(VK_LBUTTON) & 0x80) {
-            ed_bitmap_buffer buffer = ed_read_value(ed_bitmap_buffer, node->value);
+            ed_bitmap_buffer buffer = ed_read_value(ed_bitmap_buffer, ed_binding(node)->value);
             short cursor_x = LOWORD(lparam);
             short cursor_y = HIWORD(lparam);
             cursor_x = ed_clamp(cursor_x, 0, buffer.w);
             cursor_y = ed_clamp(cursor_y, 0, buffer.h);
 
-            color_picker.hsv[1] = (float)cursor_x / buffer.w;
-            color_picker.hsv[2] = (float)(buffer.h - cursor_y) / buffer.h;
-            color_picker.rgb_packed = ed_pack_rgb(color_picker.rgba);
+            ed_current->color_picker.hsv[1] = (float)cursor_x / buffer.w;
+            ed_current->color_picker.hsv[2] = (float)(buffer.h - cursor_y) / buffer.h;
+            ed_current->color_picker.rgb_packed = ed_pack_rgb(ed_current->color_picker.rgba);
 
             InvalidateRect(hwnd, NULL, FALSE);
 
-            ed_rgb_from_hsv(color_picker.rgba, color_picker.hsv);
-            ed_data(color_picker.rgba_slider, color_picker.rgba);
-            InvalidateRect(ed_hwnd(color_picker.node), NULL, FALSE);
-            ed_data(color_picker.rgb_hex, &color_picker.rgb_packed);
+            ed_rgb_from_hsv(ed_current->color_picker.rgba, ed_current->color_picker.hsv);
+            ed_data(ed_current->color_picker.rgba_slider, ed_current->color_picker.rgba);
+            InvalidateRect(ed_hwnd(ed_current->color_picker.node), NULL, FALSE);
+            ed_data(ed_current->color_picker.rgb_hex, &ed_current->color_picker.rgb_packed);
             break;
         }
     }
@@ -1457,8 +3056,8 @@ ed_color_slice_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
         HDC hdc = BeginPaint(hwnd, &ps);
 
         HDC slice_hdc = CreateCompatibleDC(hdc);
-        SelectObject(slice_hdc, (HBITMAP)node->value_ptr);
-        ed_bitmap_buffer buffer = ed_read_value(ed_bitmap_buffer, node->value);
+        SelectObject(slice_hdc, (HBITMAP)ed_binding(node)->value_ptr);
+        ed_bitmap_buffer buffer = ed_read_value(ed_bitmap_buffer, ed_binding(node)->value);
 
         int dst_w = rect.right - rect.left;
         int dst_h = rect.bottom - rect.top;
@@ -1466,8 +3065,8 @@ ed_color_slice_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
         StretchBlt(hdc, 0, 0, dst_w, dst_h,
                 slice_hdc, 0, 0, buffer.w, buffer.h, SRCCOPY);
 
-        int cursor_x = (int)(color_picker.hsv[1] * buffer.w);
-        int cursor_y = (int)((1 - color_picker.hsv[2]) * buffer.h);
+        int cursor_x = (int)(ed_current->color_picker.hsv[1] * buffer.w);
+        int cursor_y = (int)((1 - ed_current->color_picker.hsv[2]) * buffer.h);
 
         HPEN outer_border = CreatePen(PS_SOLID, 1, RGB(0, 0, 0));
         HPEN inner_border = CreatePen(PS_SOLID, 1, RGB(255, 255, 255));
@@ -1503,29 +3102,29 @@ ed_color_hue_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
     }
     case WM_MOUSEMOVE: {
         if (GetKeyState(VK_LBUTTON) & 0x80) {
-            ed_bitmap_buffer buffer = ed_read_value(ed_bitmap_buffer, node->value);
+            ed_bitmap_buffer buffer = ed_read_value(ed_bitmap_buffer, ed_binding(node)->value);
 
             if (buffer.h > buffer.w) {
                 short cursor_y = HIWORD(lparam);
                 cursor_y = ed_clamp(cursor_y, 0, buffer.h);
-                color_picker.hsv[0] = (float)(buffer.h - cursor_y) / buffer.h;
+                ed_current->color_picker.hsv[0] = (float)(buffer.h - cursor_y) / buffer.h;
             } else {
                 short cursor_x = LOWORD(lparam);
                 cursor_x = ed_clamp(cursor_x, 0, buffer.w);
-                color_picker.hsv[0] = (float)cursor_x / buffer.w;
+                ed_current->color_picker.hsv[0] = (float)cursor_x / buffer.w;
             }
 
-            ed_rgb_from_hsv(color_picker.rgba, color_picker.hsv);
-            color_picker.rgb_packed = ed_pack_rgb(color_picker.rgba);
-            ed_data(color_picker.rgba_slider, color_picker.rgba);
+            ed_rgb_from_hsv(ed_current->color_picker.rgba, ed_current->color_picker.hsv);
+            ed_current->color_picker.rgb_packed = ed_pack_rgb(ed_current->color_picker.rgba);
+            ed_data(ed_current->color_picker.rgba_slider, ed_current->color_picker.rgba);
             InvalidateRect(hwnd, NULL, FALSE);
 
             // Updating hue changes which hue slice to show.
             ed_update_color_picker_slice();
 
-            InvalidateRect(ed_hwnd(color_picker.slice), NULL, FALSE);
-            InvalidateRect(ed_hwnd(color_picker.node), NULL, FALSE);
-            ed_data(color_picker.rgb_hex, &color_picker.rgb_packed);
+            InvalidateRect(ed_hwnd(ed_current->color_picker.slice), NULL, FALSE);
+            InvalidateRect(ed_hwnd(ed_current->color_picker.node), NULL, FALSE);
+            ed_data(ed_current->color_picker.rgb_hex, &ed_current->color_picker.rgb_packed);
             break;
         }
     }
@@ -1540,8 +3139,8 @@ ed_color_hue_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
         HDC hdc = BeginPaint(hwnd, &ps);
 
         HDC hue_hdc = CreateCompatibleDC(hdc);
-        SelectObject(hue_hdc, (HBITMAP)node->value_ptr);
-        ed_bitmap_buffer buffer = ed_read_value(ed_bitmap_buffer, node->value);
+        SelectObject(hue_hdc, (HBITMAP)ed_binding(node)->value_ptr);
+        ed_bitmap_buffer buffer = ed_read_value(ed_bitmap_buffer, ed_binding(node)->value);
 
         int dst_w = rect.right - rect.left;
         int dst_h = rect.bottom - rect.top;
@@ -1555,7 +3154,7 @@ ed_color_hue_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
         INT index[] = {3, 3};
         if (buffer.h > buffer.w) {
             // Drawing this |> <|
-            int cursor_y = (int)((1 - color_picker.hsv[0]) * buffer.h);
+            int cursor_y = (int)((1 - ed_current->color_picker.hsv[0]) * buffer.h);
             POINT tris[6] = {
                 {0, cursor_y - 6},
                 {6, cursor_y},
@@ -1566,7 +3165,7 @@ ed_color_hue_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
             };
             PolyPolygon(hdc, tris, index, ARRAYSIZE(index));
         } else {
-            int cursor_x = (int)(color_picker.hsv[0] * buffer.w);
+            int cursor_x = (int)(ed_current->color_picker.hsv[0] * buffer.w);
             POINT tris[6] = {
                 {cursor_x - 6, 0},
                 {cursor_x, 6},
@@ -1594,13 +3193,14 @@ ed_edit_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam,
 {
 #define write_number_value(Type, node, value, valid)                           \
     {                                                                          \
+        ed_node_binding *binding = ed_binding(node);                           \
         if (valid) {                                                           \
-            Type val_min = ed_read_value(Type, node->value_min);               \
-            Type val_max = ed_read_value(Type, node->value_max);               \
+            Type val_min = ed_read_value(Type, binding->value_min);            \
+            Type val_max = ed_read_value(Type, binding->value_max);            \
             if (val_min != val_max) value = ed_clamp(value, val_min, val_max); \
-            ed_write_value(Type, node->value, &value);                         \
-            if (node->onchange) node->onchange(node);                          \
-            ed_write_value(Type, node->value_ptr, node->value);                \
+            ed_write_value(Type, binding->value, &value);                      \
+            if (binding->onchange) binding->onchange(node);                    \
+            ed_write_value(Type, binding->value_ptr, binding->value);          \
         }                                                                      \
         ed_invalidate_data(node);                                              \
     }
@@ -1620,16 +3220,21 @@ ed_edit_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam,
             break;
         }
         // fallthrough
-    case WM_KILLFOCUS:
-        if (node->value_ptr && !(node->flags & ED_READONLY)) {
-            if (node->value_type == ED_STRING) {
-                if (node->value_size > 0) {
+    case WM_KILLFOCUS: {
+        ed_node_binding *binding = ed_binding(node);
+        if (binding->value_ptr && !(node->flags & ED_READONLY)) {
+            if (binding->value_type == ED_STRING) {
+                if (binding->value_size > 0) {
                     size_t min_size = (size_t)(GetWindowTextLengthA(ed_hwnd(node)) + 1);
-                    ed_write_value(size_t, node->value, &min_size);
+                    ed_write_value(size_t, binding->value, &min_size);
 
-                    if (node->onchange) node->onchange(node);
-                    GetWindowTextA(ed_hwnd(node),
-                            (char *)node->value_ptr, (int)node->value_size);
+                    if (binding->onchange) binding->onchange(node);
+                    GetWindowTextA(ed_hwnd(node), (char *)binding->value_ptr,
+                            (int)binding->value_size);
+                    ed_set_text_hash(binding);
+                } else {
+                    // The edited text is not written back, ed_data restores it.
+                    binding->text_length = 0;
                 }
                 break;
             }
@@ -1637,9 +3242,9 @@ ed_edit_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam,
             char buf[64];
             char *end;
             int len = GetWindowTextA(ed_hwnd(node), buf, sizeof buf);
-            int base = ed_read_value(int, &node->value[8]);
+            int base = ed_read_value(int, &binding->value[8]);
 
-            switch (node->value_type) {
+            switch (binding->value_type) {
             case ED_INT: {
                 int value = (int)strtol(buf, &end, base);
                 write_number_value(int, node, value, (end - buf) == len);
@@ -1666,6 +3271,7 @@ ed_edit_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam,
         }
         break;
     }
+    }
 
     if (msg == WM_CHAR && wparam == VK_RETURN) {
         LONG style = GetWindowLongA(hwnd, GWL_STYLE);
@@ -1697,9 +3303,10 @@ ed_number_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam,
 
 #define update_slider(Type, node, mouse_x, mouse_acc, delta_x)           \
     {                                                                    \
-        Type value = ed_read_value(Type, node->value);                   \
-        Type val_min = ed_read_value(Type, node->value_min);             \
-        Type val_max = ed_read_value(Type, node->value_max);             \
+        ed_node_binding *binding = ed_binding(node);                     \
+        Type value = ed_read_value(Type, binding->value);                \
+        Type val_min = ed_read_value(Type, binding->value_min);          \
+        Type val_max = ed_read_value(Type, binding->value_max);          \
                                                                          \
         if (mouse_acc > ed_style.number_input_deadzone) {                \
             if (val_min != val_max) {                                    \
@@ -1715,32 +3322,34 @@ ed_number_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam,
             }                                                            \
         }                                                                \
                                                                          \
-        ed_write_value(Type, node->value, &value);                       \
-        if (node->onchange) node->onchange(node);                        \
+        ed_write_value(Type, binding->value, &value);                    \
+        if (binding->onchange) binding->onchange(node);                  \
                                                                          \
-        ed_write_value(Type, node->value_ptr, &value);                   \
+        ed_write_value(Type, binding->value_ptr, &value);                \
         ed_invalidate_data(node);                                        \
     }
 
 #define fill_slider(Type, node, hdc, rc_slide)                           \
     {                                                                    \
-        Type value = ed_read_value(Type, node->value);                   \
-        Type val_min = ed_read_value(Type, node->value_min);             \
-        Type val_max = ed_read_value(Type, node->value_max);             \
+        ed_node_binding *binding = ed_binding(node);                     \
+        Type value = ed_read_value(Type, binding->value);                \
+        Type val_min = ed_read_value(Type, binding->value_min);          \
+        Type val_max = ed_read_value(Type, binding->value_max);          \
         if (val_min != val_max) {                                        \
             double t = (value - val_min) / (double)(val_max - val_min);  \
             double w = (double)(rc_slider.right - rc_slider.left) * t;   \
             int right_max = rc_slider.right;                             \
             rc_slider.right = (int)(rc_slider.left + w);                 \
             rc_slider.right = ed_min(rc_slider.right, right_max);        \
-            FillRect(hdc, &rc_slider, brushes[ED_COLOR_HIGHLIGHT]);      \
+            FillRect(hdc, &rc_slider,                                    \
+                    ed_current->brushes[ED_COLOR_HIGHLIGHT]);            \
         } else {                                                         \
             rc_slider.right = rc_slider.left;                            \
         }                                                                \
     }
 
-    static short last_mouse_x = 0;
-    static int mouse_acc = 0;
+    static ED_THREAD_LOCAL short last_mouse_x = 0;
+    static ED_THREAD_LOCAL int mouse_acc = 0;
 
     (void)id;
     (void)data;
@@ -1809,7 +3418,7 @@ ed_number_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam,
         break;
     }
     case WM_MOUSEMOVE: {
-        if (!node->value_ptr) {
+        if (!ed_binding(node)->value_ptr) {
             break;
         }
         if (!(node->flags & ED_EDITING) && (GetKeyState(VK_LBUTTON) & 0x80)) {
@@ -1818,7 +3427,7 @@ ed_number_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam,
             mouse_acc += ed_abs(mouse_delta);
             last_mouse_x = mouse_x;
 
-            switch (node->value_type) {
+            switch (ed_binding(node)->value_type) {
             case ED_INT:
                 update_slider(int, node, mouse_x, mouse_acc, mouse_delta);
                 break;
@@ -1854,10 +3463,10 @@ ed_number_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam,
             HBITMAP hbm = CreateCompatibleBitmap(hdc, width, height);
             SelectObject(buf_hdc, hbm);
 
-            FillRect(buf_hdc, &rect, brushes[ED_COLOR_WINDOW]);
+            FillRect(buf_hdc, &rect, ed_current->brushes[ED_COLOR_WINDOW]);
             RECT rc_slider = rect;
 
-            switch (node->value_type) {
+            switch (ed_binding(node)->value_type) {
             case ED_INT: fill_slider(int, node, buf_hdc, rc_slider); break;
             case ED_FLOAT: fill_slider(float, node, buf_hdc, rc_slider); break;
             case ED_INT64: fill_slider(long long, node, buf_hdc, rc_slider); break;
@@ -1865,9 +3474,9 @@ ed_number_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam,
             default: break;
             }
 
-            FrameRect(buf_hdc, &rect, brushes[ED_COLOR_GRAYTEXT]);
+            FrameRect(buf_hdc, &rect, ed_current->brushes[ED_COLOR_GRAYTEXT]);
 
-            SelectObject(buf_hdc, ui_font);
+            SelectObject(buf_hdc, ed_current->ui_font);
             SetTextColor(buf_hdc, ed_style.colors[ED_COLOR_WINDOWTEXT]);
             SetBkColor(buf_hdc, ed_style.colors[ED_COLOR_WINDOW]);
 
@@ -1908,7 +3517,7 @@ static LRESULT __stdcall
 ed_tabstop_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam,
         UINT_PTR id, DWORD_PTR data)
 {
-    static bool vk_shift_down = false;
+    static ED_THREAD_LOCAL bool vk_shift_down = false;
 
     (void)id;
     (void)data;
@@ -1964,9 +3573,18 @@ ed_text_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam,
     LRESULT result = DefSubclassProc(hwnd, msg, wparam, lparam);
 
     if (msg == WM_SETTEXT) {
-        if (node->rect.w == 0 || node->rect.h == 0) {
-            ed_measure_text_bounds(node);
-            ed_invalidate(node);
+        if ((node->rect.w == 0 || node->rect.h == 0)
+                && ed_measure_text_bounds(node, (const char *)lparam)) {
+            // Reflow from the nearest parent whose size does not depend on its
+            // children, nothing above it can move.
+            ed_node *p = node->parent;
+            while (p->parent && (p->rect.w == 0 || p->rect.h == 0
+                        || (p->flags & ED_COLLAPSED))) {
+                p = p->parent;
+            }
+
+            ed_mark_dirty(node);
+            ed_invalidate(p);
         }
     }
     return result;
@@ -1977,12 +3595,77 @@ ed_register_class(const char *name, WNDPROC proc)
 {
     WNDCLASSA wnd_class = {0};
     wnd_class.lpfnWndProc   = proc;
+    wnd_class.cbWndExtra    = sizeof(struct ed_context *);
     wnd_class.hInstance     = GetModuleHandleA(NULL);
     wnd_class.hCursor       = LoadCursorA(NULL, IDC_ARROW);
     wnd_class.lpszClassName = name;
     return RegisterClassA(&wnd_class);
 }
 
+// Makes the context owning `hwnd` current. Returns the previously current
+// context, which is restored once the message is handled.
+static struct ed_context *
+ed_enter_window_context(HWND hwnd)
+{
+    struct ed_context *saved = ed_current;
+    struct ed_context *context =
+        (struct ed_context *)GetWindowLongPtrA(hwnd, ED_WND_CONTEXT);
+
+    // Messages sent during CreateWindow arrive before the context is set.
+    if (context) ed_current = context;
+    return saved;
+}
+
+// Defines `proc`_in_context, which runs `proc` with the context owning the
+// window made current.
+#define ed_context_wndproc(proc)                                               \
+    static LRESULT __stdcall                                                   \
+    proc##_in_context(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)       \
+    {                                                                          \
+        struct ed_context *saved = ed_enter_window_context(hwnd);              \
+        LRESULT result = proc(hwnd, msg, wparam, lparam);                      \
+        ed_current = saved;                                                    \
+        return result;                                                         \
+    }
+
+// Same as `ed_context_wndproc` for subclass procs. The context is passed as
+// the subclass reference data.
+#define ed_context_subclassproc(proc)                                          \
+    static LRESULT __stdcall                                                   \
+    proc##_in_context(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam,       \
+            UINT_PTR id, DWORD_PTR data)                                       \
+    {                                                                          \
+        struct ed_context *saved = ed_current;                                 \
+        ed_current = (struct ed_context *)data;                                \
+        LRESULT result = proc(hwnd, msg, wparam, lparam, id, data);            \
+        ed_current = saved;                                                    \
+        return result;                                                         \
+    }
+
+ed_context_wndproc(ed_window_proc)
+ed_context_wndproc(ed_user_window_proc)
+ed_context_wndproc(ed_caption_proc)
+ed_context_wndproc(ed_image_proc)
+ed_context_wndproc(ed_color_proc)
+ed_context_wndproc(ed_color_slice_proc)
+ed_context_wndproc(ed_color_hue_proc)
+ed_context_subclassproc(ed_edit_proc)
+ed_context_subclassproc(ed_number_proc)
+ed_context_subclassproc(ed_tabstop_proc)
+ed_context_subclassproc(ed_text_proc)
+
+// Stores the current context in windows of ED_* classes so their window procs
+// run in the context owning the window.
+static void
+ed_set_window_context(HWND hwnd)
+{
+    char class_name[16];
+    if (GetClassNameA(hwnd, class_name, sizeof class_name) > 3
+            && strncmp(class_name, "ED_", 3) == 0) {
+        SetWindowLongPtrA(hwnd, ED_WND_CONTEXT, (LONG_PTR)ed_current);
+    }
+}
+
 static ed_node *
 ed_input_basic(ed_value_type value_type)
 {
@@ -1990,22 +3673,23 @@ ed_input_basic(ed_value_type value_type)
     ed_node *node = ed_attach(ED_INPUT, rect.x, rect.y, rect.w, rect.h);
     node->spacing = ed_style.spacing;
     node->flags = ED_TABSTOP | ED_TEXTNODE;
-    node->value_type = value_type;
-    memset(&node->value, 0, sizeof node->value);
+    ed_node_binding *binding = ed_binding(node);
+    binding->value_type = value_type;
+    memset(&binding->value, 0, sizeof binding->value);
 
     ed_attach_hwnd(node, "EDIT", "", WS_CHILD | WS_VISIBLE | WS_BORDER | ES_AUTOHSCROLL);
-    ed_measure_text_bounds(node);
-    SetWindowSubclass(ed_hwnd(node), ed_edit_proc, 0, 0);
-    SetWindowSubclass(ed_hwnd(node), ed_tabstop_proc, 1, 0);
-    SetWindowSubclass(ed_hwnd(node), ed_text_proc, 2, 0);
+    ed_measure_text_bounds(node, "");
+    SetWindowSubclass(ed_hwnd(node), ed_edit_proc_in_context, 0, (DWORD_PTR)ed_current);
+    SetWindowSubclass(ed_hwnd(node), ed_tabstop_proc_in_context, 1, (DWORD_PTR)ed_current);
+    SetWindowSubclass(ed_hwnd(node), ed_text_proc_in_context, 2, (DWORD_PTR)ed_current);
 
-    if (node->value_type >= ED_VALUE_TYPE_NUMBER_MIN
-            && node->value_type <= ED_VALUE_TYPE_NUMBER_MAX) {
-        SetWindowSubclass(ed_hwnd(node), ed_number_proc, 3, 0);
+    if (binding->value_type >= ED_VALUE_TYPE_NUMBER_MIN
+            && binding->value_type <= ED_VALUE_TYPE_NUMBER_MAX) {
+        SetWindowSubclass(ed_hwnd(node), ed_number_proc_in_context, 3, (DWORD_PTR)ed_current);
     }
 
-    // node->value_ptr starts by pointing to the internal value storage.
-    ed_data(node, node->value);
+    // binding->value_ptr starts by pointing to the internal value storage.
+    ed_data(node, binding->value);
     return node;
 }
 
@@ -2013,43 +3697,348 @@ ed_input_basic(ed_value_type value_type)
 //
 // Valid ids are in range:
 //
-//     1 <= id < ED_NODE_COUNT <= 0x7FFF
+//     1 <= id <= INT_MAX
 //
 // A node with id=ED_ID_ROOT is the root window. The root window also has a
-// null parent, all other valid nodes have a parent node.
+// null parent, all other valid nodes have a parent node. Ids are stable for
+// the lifetime of the node, the id of a removed node may be given to a new
+// node.
 ed_node *
-ed_index_node(short id)
+ed_index_node(int id)
 {
-    assert((size_t)id < ARRAYSIZE(ed_tree));
-    return &ed_tree[id];
+    struct ed_node_chunk *chunk = ed_node_chunk(id);
+    assert(chunk->nodes && "node id refers to a released chunk.");
+    return &chunk->nodes[(unsigned)id % ED_TREE_CHUNK_SIZE];
 }
 
-// Initializes the library.
+// Returns the value and binding data of a node.
+ed_node_binding *
+ed_binding(ed_node *node)
+{
+    struct ed_node_chunk *chunk = ed_node_chunk(node->id);
+    return &chunk->bindings[(unsigned)node->id % ED_TREE_CHUNK_SIZE];
+}
+
+// Returns a handle to the node. Unlike a node pointer, a handle can be kept
+// after the node is removed: `ed_resolve` then returns NULL and functions
+// taking a handle do nothing.
+ed_handle
+ed_get_handle(ed_node *node)
+{
+    ed_node_binding *binding = ed_binding(node);
+    if (binding->handle) {
+        return binding->handle;
+    }
+
+    unsigned index = ed_current->handles.free_slot;
+    if (index) {
+        ed_current->handles.free_slot = ed_current->handles.slots[index].next_free;
+    } else {
+        if (ed_current->handles.count == ed_current->handles.capacity) {
+            unsigned capacity = ed_max(2 * ed_current->handles.capacity, 64);
+            struct ed_handle_slot *slots = (struct ed_handle_slot *)realloc(
+                    ed_current->handles.slots, capacity * sizeof(struct ed_handle_slot));
+            assert(slots && "out of memory.");
+
+            ed_current->handles.slots = slots;
+            ed_current->handles.capacity = capacity;
+        }
+
+        if (ed_current->handles.count == 0) {
+            // Reserve slot 0 for ED_HANDLE_NULL.
+            memset(&ed_current->handles.slots[0], 0, sizeof(struct ed_handle_slot));
+            ed_current->handles.count = 1;
+        }
+
+        index = ed_current->handles.count++;
+        assert(index <= ED_HANDLE_INDEX_MASK && "too many node handles.");
+        ed_current->handles.slots[index].generation = 0;
+    }
+
+    struct ed_handle_slot *slot = &ed_current->handles.slots[index];
+    slot->id = node->id;
+    binding->handle = (slot->generation << ED_HANDLE_INDEX_BITS) | index;
+    return binding->handle;
+}
+
+// Returns the node referred to by `handle`, or NULL if the node was removed.
+ed_node *
+ed_resolve(ed_handle handle)
+{
+    unsigned index = handle & ED_HANDLE_INDEX_MASK;
+    if (index == 0 || index >= ed_current->handles.count) {
+        return NULL;
+    }
+
+    struct ed_handle_slot *slot = &ed_current->handles.slots[index];
+    if (!slot->id || slot->generation != (handle >> ED_HANDLE_INDEX_BITS)) {
+        return NULL;
+    }
+
+    return ed_index_node(slot->id);
+}
+
+// Returns the fraction of nodes that do not directly follow the node before
+// them in depth-first order. A freshly compacted tree has no fragmentation.
+// Walks the whole tree, check it between frames to decide when to call
+// `ed_compact`.
+float
+ed_fragmentation(void)
+{
+    ed_node *root = ed_index_node(ED_ID_ROOT);
+    unsigned scattered = 0;
+    int prev_id = ED_ID_ROOT - 1;
+
+    for (ed_node *n = root; n; n = ed_preorder_next(n, root)) {
+        if (n->id != prev_id + 1) ++scattered;
+        prev_id = n->id;
+    }
+    return ed_current->active_node_count ? (float)scattered / ed_current->active_node_count : 0.0f;
+}
+
+// Sets the name used to find `node` with `ed_find`. Names are scoped to the
+// nearest named ancestor, so the path of a node is the names of its named
+// ancestors and its own name separated by '/'.
 //
-// hwnd:
-//   The root window of the application.
+// Windows and groups are named after their caption. Other nodes, including
+// labeled inputs, are only named by calling this.
+//
+// name:
+//   The name is copied. If NULL, the node is unnamed.
 void
-ed_init(void *hwnd)
+ed_set_name(ed_node *node, const char *name)
 {
-    if (ed_index_node(ED_ID_ROOT)->id == ED_ID_ROOT) {
-        // Already initialized
-        return;
+    assert(node->parent && "cannot name the root node.");
+    ed_node_binding *binding = ed_binding(node);
+
+    if (binding->name) {
+        ed_name_erase(node);
+        free(binding->name);
+        binding->name = NULL;
     }
 
-    memset(&ed_style, 0, sizeof ed_style);
-    memset(&ed_stats, 0, sizeof ed_stats);
-    memset(&ed_ctx, 0, sizeof ed_ctx);
-    used_node_count = 0;
-    registered_update_count = 0;
+    if (name) {
+        size_t len = strlen(name) + 1;
+        binding->name = (char *)malloc(len);
+        assert(binding->name && "out of memory.");
+        memcpy(binding->name, name, len);
+        ed_name_insert(node);
+    }
 
-    ed_apply_system_colors();
-    ed_allocate_colors();
+    // Named descendants may now be scoped to this node.
+    for (ed_node *n = node->child; n; n = ed_preorder_next(n, node)) {
+        if (ed_binding(n)->name) {
+            ed_name_erase(n);
+            ed_name_insert(n);
+        }
+    }
+}
 
-    // Default UI font
-    NONCLIENTMETRICS ncmetrics = {0};
-    ncmetrics.cbSize = sizeof(ncmetrics);
-    SystemParametersInfoA(SPI_GETNONCLIENTMETRICS, sizeof(ncmetrics), &ncmetrics, 0);
-    ui_font = CreateFontIndirectA(&ncmetrics.lfStatusFont);
+// Returns the node at `path`, or NULL if no such node exists. Each segment of
+// the path is looked up in the scope of the node found for the previous
+// segment, so lookup time depends on the depth of the path and not on the size
+// of the tree.
+//
+//     ed_begin_window("Physics", ED_VERT, 0, 0, 300, 400);
+//     ed_begin_group("Solver", ED_VERT, 0, 0, 1.0f, 0);
+//     ed_set_name(ed_int("Iterations", 1, 64), "Iterations");
+//     ...
+//     ed_data(ed_find("Physics/Solver/Iterations"), &iterations);
+//
+// If more than one node with the same name shares a scope, any one of them may
+// be returned.
+ed_node *
+ed_find(const char *path)
+{
+    struct ed_name_index *names = &ed_current->names;
+    if (!names->count) {
+        return NULL;
+    }
+
+    unsigned mask = names->capacity - 1;
+    int scope = ED_ID_ROOT;
+    ed_node *node = NULL;
+
+    while (*path) {
+        size_t len = strcspn(path, "/");
+        unsigned hash = ed_hash_name(path, len, scope);
+
+        node = NULL;
+        for (unsigned i = hash & mask; names->entries[i].id; i = (i + 1) & mask) {
+            struct ed_name_entry *entry = &names->entries[i];
+            if (entry->hash != hash || entry->scope != scope) continue;
+
+            ed_node *n = ed_index_node(entry->id);
+            const char *name = ed_binding(n)->name;
+            if (strncmp(name, path, len) == 0 && name[len] == '\0') {
+                node = n;
+                break;
+            }
+        }
+
+        if (!node) return NULL;
+        scope = node->id;
+        path += len;
+        if (*path == '/') ++path;
+    }
+    return node;
+}
+
+// Maps a node from the arena being compacted to its copy in the new arena.
+static ed_node *
+ed_compact_remap(ed_node *node, const int *new_ids, struct ed_node_chunk *chunks)
+{
+    if (!node) return NULL;
+    int id = new_ids[node->id];
+    return &chunks[(unsigned)id / ED_TREE_CHUNK_SIZE].nodes[(unsigned)id % ED_TREE_CHUNK_SIZE];
+}
+
+// Renumbers all nodes in depth-first order so siblings and children are next to
+// each other in memory, and releases any unused chunks. Every link and id
+// stored by the library is rewritten, including window user data and control
+// ids.
+//
+// All `ed_node` pointers held by the application are invalid after this call,
+// use `ed_get_handle` to keep a reference to a node across compactions. The
+// library never compacts on its own, call this where the application holds
+// no node pointers.
+void
+ed_compact(void)
+{
+    ed_current->stats->fragmentation_before = ed_fragmentation();
+
+    unsigned id_count = ed_current->arena.chunk_count * ED_TREE_CHUNK_SIZE;
+    int *new_ids = (int *)calloc(id_count, sizeof(int));
+    assert(new_ids && "out of memory.");
+
+    // Id 0 is never handed out, so node ids run from 1 to the number of
+    // active nodes.
+    ed_node *root = ed_index_node(ED_ID_ROOT);
+    int next_id = ED_ID_ROOT;
+    for (ed_node *n = root; n; n = ed_preorder_next(n, root)) {
+        new_ids[n->id] = next_id++;
+    }
+    assert((unsigned)(next_id - ED_ID_ROOT) == ed_current->active_node_count
+            && "node not reachable from the root.");
+
+    unsigned chunk_count = (unsigned)(next_id - 1) / ED_TREE_CHUNK_SIZE + 1;
+    unsigned chunk_capacity = ed_max(chunk_count, 16);
+    struct ed_node_chunk *chunks = (struct ed_node_chunk *)calloc(
+            chunk_capacity, sizeof(struct ed_node_chunk));
+    assert(chunks && "out of memory.");
+
+    for (unsigned c = 0; c < chunk_count; ++c) {
+        chunks[c].nodes = (ed_node *)calloc(ED_TREE_CHUNK_SIZE, sizeof(ed_node));
+        chunks[c].bindings = (ed_node_binding *)calloc(ED_TREE_CHUNK_SIZE,
+                sizeof(ed_node_binding));
+        assert(chunks[c].nodes && chunks[c].bindings && "out of memory.");
+
+        unsigned first = c * ED_TREE_CHUNK_SIZE;
+        chunks[c].used = ed_min((unsigned)next_id - first, ED_TREE_CHUNK_SIZE);
+        chunks[c].active = c == 0 ? chunks[c].used - ED_ID_ROOT : chunks[c].used;
+    }
+
+    for (ed_node *n = root; n; n = ed_preorder_next(n, root)) {
+        unsigned id = (unsigned)new_ids[n->id];
+        ed_node *node = &chunks[id / ED_TREE_CHUNK_SIZE].nodes[id % ED_TREE_CHUNK_SIZE];
+        ed_node_binding *binding = &chunks[id / ED_TREE_CHUNK_SIZE].bindings[id % ED_TREE_CHUNK_SIZE];
+
+        *node = *n;
+        *binding = *ed_binding(n);
+
+        node->id = (int)id;
+        node->parent = ed_compact_remap(n->parent, new_ids, chunks);
+        node->child = ed_compact_remap(n->child, new_ids, chunks);
+        node->before = ed_compact_remap(n->before, new_ids, chunks);
+        node->after = ed_compact_remap(n->after, new_ids, chunks);
+        if (n->scroll_bar) node->scroll_bar = new_ids[n->scroll_bar];
+        if (n->scroll_client) node->scroll_client = new_ids[n->scroll_client];
+        binding->node_list = ed_compact_remap(binding->node_list, new_ids, chunks);
+
+        if (binding->handle) {
+            ed_current->handles.slots[binding->handle & ED_HANDLE_INDEX_MASK].id = node->id;
+        }
+
+        if (n->hwnd && n != root) {
+            HWND hwnd = ed_hwnd(n);
+            if (GetWindowLongPtrA(hwnd, GWLP_USERDATA) == (LONG_PTR)n) {
+                SetWindowLongPtrA(hwnd, GWLP_USERDATA, (LONG_PTR)node);
+            }
+            if ((GetWindowLongA(hwnd, GWL_STYLE) & WS_CHILD)
+                    && GetWindowLongPtrA(hwnd, GWLP_ID) == (LONG_PTR)n->id) {
+                SetWindowLongPtrA(hwnd, GWLP_ID, (LONG_PTR)node->id);
+            }
+        }
+    }
+
+    for (unsigned i = 0; i < ed_current->sync.count; ++i) {
+        ed_current->sync.entries[i].id = new_ids[ed_current->sync.entries[i].id];
+    }
+    for (unsigned i = 0; i < ed_current->sync.block_count; ++i) {
+        ed_current->sync.blocks[i].id = new_ids[ed_current->sync.blocks[i].id];
+    }
+    for (unsigned i = 0; i < ed_current->ranges.count; ++i) {
+        ed_current->ranges.ranges[i].id = new_ids[ed_current->ranges.ranges[i].id];
+    }
+    for (unsigned i = 0; i < ed_current->ranges.pending_count; ++i) {
+        ed_current->ranges.pending[i] = new_ids[ed_current->ranges.pending[i]];
+    }
+
+    for (unsigned i = 0; i < ed_current->reflow.count; ++i) {
+        ed_current->reflow.nodes[i] = ed_compact_remap(ed_current->reflow.nodes[i], new_ids, chunks);
+    }
+
+    for (unsigned i = 0; i < ed_current->registered_update_count; ++i) {
+        ed_current->update_funcs[i].node = ed_compact_remap(ed_current->update_funcs[i].node, new_ids, chunks);
+    }
+
+    ed_current->tree.parent = ed_compact_remap(ed_current->tree.parent, new_ids, chunks);
+    ed_current->tree.child = ed_compact_remap(ed_current->tree.child, new_ids, chunks);
+    ed_current->saved_tree.parent = ed_compact_remap(ed_current->saved_tree.parent, new_ids, chunks);
+    ed_current->saved_tree.child = ed_compact_remap(ed_current->saved_tree.child, new_ids, chunks);
+
+    ed_current->color_picker.node = ed_compact_remap(ed_current->color_picker.node, new_ids, chunks);
+    ed_current->color_picker.dialog = ed_compact_remap(ed_current->color_picker.dialog, new_ids, chunks);
+    ed_current->color_picker.slice = ed_compact_remap(ed_current->color_picker.slice, new_ids, chunks);
+    ed_current->color_picker.hue = ed_compact_remap(ed_current->color_picker.hue, new_ids, chunks);
+    ed_current->color_picker.rgba_slider = ed_compact_remap(ed_current->color_picker.rgba_slider, new_ids, chunks);
+    ed_current->color_picker.rgb_hex = ed_compact_remap(ed_current->color_picker.rgb_hex, new_ids, chunks);
+
+    for (unsigned c = 0; c < ed_current->arena.chunk_count; ++c) {
+        free(ed_current->arena.chunks[c].nodes);
+        free(ed_current->arena.chunks[c].bindings);
+    }
+    free(ed_current->arena.chunks);
+    free(new_ids);
+
+    ed_current->arena.chunks = chunks;
+    ed_current->arena.chunk_count = chunk_count;
+    ed_current->arena.chunk_capacity = chunk_capacity;
+    ed_current->arena.free_chunk = chunk_count - 1;
+    ed_current->arena.empty_chunks = 0;
+
+    // Names are keyed by the id of their scope, reindex with the new ids.
+    if (ed_current->names.entries) {
+        memset(ed_current->names.entries, 0,
+                ed_current->names.capacity * sizeof(struct ed_name_entry));
+        ed_current->names.count = 0;
+
+        root = ed_index_node(ED_ID_ROOT);
+        for (ed_node *n = root; n; n = ed_preorder_next(n, root)) {
+            if (ed_binding(n)->name) ed_name_insert(n);
+        }
+    }
+
+    ++ed_current->stats->compact_calls;
+    ed_current->stats->fragmentation_after = ed_fragmentation();
+}
+
+// Sets the default style and registers window classes.
+static void
+ed_init_shared(void)
+{
+    memset(&ed_style, 0, sizeof ed_style);
+    ed_apply_system_colors();
 
     // Default style
     ed_style.spacing = 8;
@@ -2074,24 +4063,71 @@ ed_init(void *hwnd)
     ed_style.value_formats[ED_FLOAT64] = "%.3f";
 
     // Window procs
-    ed_register_class("ED_WINDOW", ed_window_proc);
-    ed_register_class("ED_USERWINDOW", ed_user_window_proc);
-    ed_register_class("ED_CAPTION", ed_caption_proc);
-    ed_register_class("ED_IMAGE", ed_image_proc);
-    ed_register_class("ED_COLOR", ed_color_proc);
-    ed_register_class("ED_COLOR_SLICE", ed_color_slice_proc);
-    ed_register_class("ED_COLOR_HUE", ed_color_hue_proc);
+    ed_register_class("ED_WINDOW", ed_window_proc_in_context);
+    ed_register_class("ED_USERWINDOW", ed_user_window_proc_in_context);
+    ed_register_class("ED_CAPTION", ed_caption_proc_in_context);
+    ed_register_class("ED_IMAGE", ed_image_proc_in_context);
+    ed_register_class("ED_COLOR", ed_color_proc_in_context);
+    ed_register_class("ED_COLOR_SLICE", ed_color_slice_proc_in_context);
+    ed_register_class("ED_COLOR_HUE", ed_color_hue_proc_in_context);
+}
+
+static BOOL CALLBACK
+ed_init_shared_once(INIT_ONCE *once, void *param, void **context)
+{
+    (void)once;
+    (void)param;
+    (void)context;
+    ed_init_shared();
+    return TRUE;
+}
+
+// Initializes the library.
+//
+// hwnd:
+//   The root window of the application.
+void
+ed_init(void *hwnd)
+{
+    if (ed_current->arena.chunk_count) {
+        // Already initialized
+        return;
+    }
+
+    if (ed_current == &ed_default_context) {
+        ed_current->update_funcs = ed_update_funcs;
+        ed_current->stats = &ed_stats;
+    }
+    memset(ed_current->stats, 0, sizeof(struct ed_stats));
+    memset(&ed_current->tree, 0, sizeof ed_current->tree);
+    if (!ed_current->backend.set_geometry) {
+        ed_current->backend = ed_win32_backend;
+    }
+    ed_current->active_node_count = 0;
+    ed_current->registered_update_count = 0;
+    ed_current->update_offset = 0;
+
+    // The style and window classes are shared by all contexts. Every caller
+    // waits until the first one has set them up.
+    InitOnceExecuteOnce(&ed_shared_init_once, ed_init_shared_once, NULL, NULL);
+    ed_allocate_colors();
+
+    // Default UI font
+    NONCLIENTMETRICS ncmetrics = {0};
+    ncmetrics.cbSize = sizeof(ncmetrics);
+    SystemParametersInfoA(SPI_GETNONCLIENTMETRICS, sizeof(ncmetrics), &ncmetrics, 0);
+    ed_current->ui_font = CreateFontIndirectA(&ncmetrics.lfStatusFont);
+    ed_load_font_metrics(&ed_current->ui_font_metrics, ed_current->ui_font);
 
     // Root node
-    ed_node *root = ed_index_node(ED_ID_ROOT);
-    used_node_count = ED_ID_ROOT;
-    root->id = ED_ID_ROOT;
+    ed_node *root = ed_alloc_node();
+    assert(root->id == ED_ID_ROOT);
     root->type = ED_WINDOW;
     root->flags = ED_ROOT;
     root->layout = ED_ABS;
     root->hwnd = hwnd;
-    ed_ctx.parent = root;
-    ed_ctx.child = NULL;
+    ed_current->tree.parent = root;
+    ed_current->tree.child = NULL;
 
     ed_resize(hwnd);
 }
@@ -2100,8 +4136,13 @@ ed_init(void *hwnd)
 void
 ed_deinit(void)
 {
-    for (size_t i = ED_ID_ROOT; i < used_node_count; ++i) {
-        ed_free_node_resources(&ed_tree[i]);
+    for (unsigned c = 0; c < ed_current->arena.chunk_count; ++c) {
+        struct ed_node_chunk *chunk = &ed_current->arena.chunks[c];
+        for (unsigned i = 0; chunk->nodes && i < chunk->used; ++i) {
+            if (chunk->nodes[i].type != ED_NONE) {
+                ed_free_node_resources(&chunk->nodes[i]);
+            }
+        }
     }
 
     ed_node *root = ed_index_node(ED_ID_ROOT);
@@ -2110,14 +4151,111 @@ ed_deinit(void)
     }
 
     for (size_t color = 0; color < ED_COLOR_COUNT; ++color) {
-        DeleteObject(brushes[color]);
-    }
+        DeleteObject(ed_current->brushes[color]);
+    }
+
+    if (ed_current->ui_font) {
+        DeleteObject(ed_current->ui_font);
+    }
+
+    for (unsigned c = 0; c < ed_current->arena.chunk_count; ++c) {
+        free(ed_current->arena.chunks[c].nodes);
+        free(ed_current->arena.chunks[c].bindings);
+    }
+
+    free(ed_current->arena.chunks);
+    free(ed_current->handles.slots);
+    free(ed_current->names.entries);
+    free(ed_current->measure_stack.frames);
+    free(ed_current->geometry.nodes);
+    free(ed_current->reflow.nodes);
+    free(ed_current->sync.entries);
+    free(ed_current->sync.blocks);
+    free(ed_current->ranges.ranges);
+    free(ed_current->ranges.max_end);
+    free(ed_current->ranges.pending);
+    memset(&ed_current->arena, 0, sizeof ed_current->arena);
+    memset(&ed_current->handles, 0, sizeof ed_current->handles);
+    memset(&ed_current->names, 0, sizeof ed_current->names);
+    memset(&ed_current->measure_stack, 0, sizeof ed_current->measure_stack);
+    memset(&ed_current->geometry, 0, sizeof ed_current->geometry);
+    memset(&ed_current->reflow, 0, sizeof ed_current->reflow);
+    memset(&ed_current->sync, 0, sizeof ed_current->sync);
+    memset(&ed_current->ranges, 0, sizeof ed_current->ranges);
+    memset(&ed_current->color_picker, 0, sizeof ed_current->color_picker);
+}
 
-    if (ui_font) {
-        DeleteObject(ui_font);
-    }
+// Creates a context for an independent UI tree. The context must be made
+// current with `ed_set_context` and initialized with `ed_init` before use.
+ed_context *
+ed_create_context(void)
+{
+    ed_context *context = (ed_context *)calloc(1, sizeof(ed_context));
+    assert(context && "out of memory.");
+    context->update_funcs = context->own_update_funcs;
+    context->stats = &context->own_stats;
+    return context;
+}
+
+// Frees a context created with `ed_create_context`. The context must have been
+// deinitialized with `ed_deinit`.
+void
+ed_destroy_context(ed_context *context)
+{
+    assert(context != &ed_default_context && "cannot destroy the default context.");
+    assert(!context->arena.chunk_count && "ed_deinit not called for context.");
+    if (ed_current == context) ed_current = &ed_default_context;
+    free(context);
+}
+
+// Makes `context` current for the calling thread. All ed_* calls on this
+// thread operate on the current context. Window procs switch to the context
+// owning the window while handling a message, so nodes of different contexts
+// may be mixed in the same message loop.
+//
+// A context may only be used by one thread at a time. Contexts on different
+// threads can build and lay out their trees concurrently, as long as each
+// thread owns the windows of its context. `ed_style` is shared by all contexts.
+//
+// context:
+//   The context to use, or NULL for the default context.
+void
+ed_set_context(ed_context *context)
+{
+    ed_current = context ? context : &ed_default_context;
+}
+
+// Returns the current context of the calling thread.
+ed_context *
+ed_get_context(void)
+{
+    return ed_current;
+}
+
+// Sets the backend applying the window geometry computed by the layout of the
+// current context. The backend is copied.
+//
+// backend:
+//   If NULL, the default backend using DeferWindowPos is restored.
+void
+ed_set_backend(const ed_backend *backend)
+{
+    ed_current->backend = backend ? *backend : ed_win32_backend;
+}
 
-    memset(ed_tree, 0, sizeof ed_tree);
+// Returns the backend of the current context.
+const ed_backend *
+ed_get_backend(void)
+{
+    return &ed_current->backend;
+}
+
+// Returns statistics for the current context. Same as `ed_stats` for the
+// default context.
+struct ed_stats *
+ed_get_stats(void)
+{
+    return ed_current->stats;
 }
 
 // Registers an update function to be run during `ed_update`.
@@ -2131,12 +4269,12 @@ ed_deinit(void)
 void
 ed_register_update(ed_node *node, void (*update)(void))
 {
-    assert(registered_update_count < ED_UPDATE_FUNCS_COUNT
+    assert(ed_current->registered_update_count < ED_UPDATE_FUNCS_COUNT
             && "too many registered update functions.");
 
-    ed_node_update node_update = {node, update};
-    ed_update_funcs[registered_update_count] = node_update;
-    ++registered_update_count;
+    ed_node_update node_update = {node, update, ed_current->stats->update_calls};
+    ed_current->update_funcs[ed_current->registered_update_count] = node_update;
+    ++ed_current->registered_update_count;
 
     if (node) {
         node->flags |= ED_OWNUPDATE;
@@ -2151,22 +4289,36 @@ void
 ed_unregister_update(ed_node *node)
 {
     if (!node) {
-        registered_update_count = 0;
-        memset(ed_update_funcs, 0, sizeof(ed_update_funcs));
+        ed_current->registered_update_count = 0;
+        memset(ed_current->update_funcs, 0, ED_UPDATE_FUNCS_COUNT * sizeof(ed_node_update));
+        memset(ed_current->stats->update_cost_us, 0, sizeof ed_current->stats->update_cost_us);
         return;
     }
 
     node->flags &= ~ED_OWNUPDATE;
 
-    for (size_t i = registered_update_count; i-- > 0;) {
-        if (ed_update_funcs[i].node == node) {
-            --registered_update_count;
-            ed_update_funcs[i] = ed_update_funcs[registered_update_count];
-            memset(&ed_update_funcs[registered_update_count], 0, sizeof(ed_node_update));
+    for (size_t i = ed_current->registered_update_count; i-- > 0;) {
+        if (ed_current->update_funcs[i].node == node) {
+            --ed_current->registered_update_count;
+            ed_current->update_funcs[i] = ed_current->update_funcs[ed_current->registered_update_count];
+            memset(&ed_current->update_funcs[ed_current->registered_update_count], 0, sizeof(ed_node_update));
+
+            float *costs = ed_current->stats->update_cost_us;
+            costs[i] = costs[ed_current->registered_update_count];
+            costs[ed_current->registered_update_count] = 0;
         }
     }
 }
 
+// Work done at the start of every frame by ed_update and ed_update_budget,
+// before any update function is called.
+static void
+ed_update_begin(struct ed_context *context)
+{
+    context->stats->data_calls = 0;
+    ed_range_refresh();
+}
+
 // Performs a full update by calling update functions in ed_update_funcs every
 // `n` frames. If `n > 1` this tries to spread update calls to subsequent
 // frames.
@@ -2180,50 +4332,158 @@ ed_unregister_update(ed_node *node)
 //     ed_update(2); // A B
 //     // ...
 //
-// update_every_n_frames:
-//   How many frames until all update calls registered with
-//   `ed_register_update` are called.
+// update_every_n_frames:
+//   How many frames until all update calls registered with
+//   `ed_register_update` are called.
+//
+//   If `ed_update(4)` is called 60 times per
+//   second, each registered update call gets called 15 times per second.
+void
+ed_update(unsigned update_every_n_frames)
+{
+    // Update functions may switch to another context.
+    struct ed_context *context = ed_current;
+
+    ed_update_begin(context);
+    LARGE_INTEGER start, end;
+    QueryPerformanceCounter(&start);
+
+    unsigned groups = ed_max(update_every_n_frames, 1);
+    unsigned chunk = context->registered_update_count / groups;
+
+    if (chunk <= 0 && (context->stats->update_calls % groups) != 0) {
+        // If the chunk size is too small, run all update calls in the same
+        // frame.
+        goto next_frame;
+    }
+    if (context->update_offset >= context->registered_update_count) {
+        context->update_offset = 0;
+    }
+    if (context->update_offset == 0) {
+        chunk += context->registered_update_count % groups;
+    }
+
+    for (unsigned i = context->update_offset, chunk_end = context->update_offset + chunk;
+            i < chunk_end; ++i) {
+        ed_node_update *node_update = &context->update_funcs[i];
+        if (node_update->node && !ed_is_visible(node_update->node)) {
+            // Hidden nodes are not updated.
+            continue;
+        }
+        if (node_update->update) node_update->update();
+    }
+    context->update_offset += chunk;
+
+next_frame:
+    ++context->stats->update_calls;
+    QueryPerformanceCounter(&end);
+    context->stats->update_ticks = end.QuadPart - start.QuadPart;
+}
+
+// Calls update function `i` of a context, adds the time taken to `spent_us`
+// and to the moving average of the function.
+static void
+ed_update_call(struct ed_context *context, unsigned i, double us_per_tick, double *spent_us)
+{
+    struct ed_stats *stats = context->stats;
+    ed_node_update *node_update = &context->update_funcs[i];
+    node_update->last_frame = stats->update_calls + 1;
+
+    LARGE_INTEGER start, end;
+    QueryPerformanceCounter(&start);
+    if (node_update->update) node_update->update();
+    QueryPerformanceCounter(&end);
+
+    float us = (float)((end.QuadPart - start.QuadPart) * us_per_tick);
+    float *cost = &stats->update_cost_us[i];
+    *cost = *cost > 0.0f ? *cost + (us - *cost) * 0.125f : us;
+    *spent_us += us;
+    ++stats->update_funcs_called;
+}
+
+// Calls update functions registered with `ed_register_update` round-robin
+// until `budget_us` microseconds are spent, instead of the fixed share of
+// functions per frame of `ed_update`. A function whose average cost exceeds
+// what is left of the budget waits for a later frame, so one expensive
+// function does not blow the frame while cheap ones still run.
+//
+// Visible functions which were last called `max_wait_frames` frames ago are
+// called first, regardless of the budget, so every function associated with
+// a visible node, or with no node, is called at least once every
+// `max_wait_frames` frames.
 //
-//   If `ed_update(4)` is called 60 times per
-//   second, each registered update call gets called 15 times per second.
+// The cost of each function is tracked in `ed_stats.update_cost_us`.
+//
+// budget_us:
+//   Time in microseconds for update functions each frame. At least one
+//   function is called per frame, even if it exceeds the budget.
+//
+// max_wait_frames:
+//   Most frames between two calls to a visible update function.
 void
-ed_update(unsigned update_every_n_frames)
+ed_update_budget(unsigned budget_us, unsigned max_wait_frames)
 {
-    static unsigned offset = 0;
+    // Update functions may switch to another context.
+    struct ed_context *context = ed_current;
+    struct ed_stats *stats = context->stats;
 
-    LARGE_INTEGER start, end;
+    ed_update_begin(context);
+    LARGE_INTEGER freq, start, end;
+    QueryPerformanceFrequency(&freq);
     QueryPerformanceCounter(&start);
-    ed_stats.data_calls = 0;
 
-    unsigned groups = ed_max(update_every_n_frames, 1);
-    unsigned chunk = registered_update_count / groups;
+    double us_per_tick = 1e6 / (double)freq.QuadPart;
+    double spent_us = 0.0;
+    unsigned frame = stats->update_calls;
+    unsigned count = context->registered_update_count;
+    max_wait_frames = ed_max(max_wait_frames, 1);
+    stats->update_funcs_called = 0;
+    stats->update_funcs_overdue = 0;
+
+    for (unsigned i = 0; i < count; ++i) {
+        ed_node_update *node_update = &context->update_funcs[i];
+        if (frame + 1 - node_update->last_frame < max_wait_frames) {
+            continue;
+        }
+        if (node_update->node && !ed_is_visible(node_update->node)) {
+            // Hidden nodes are not updated.
+            continue;
+        }
 
-    if (chunk <= 0 && (ed_stats.update_calls % groups) != 0) {
-        // If the chunk size is too small, run all update calls in the same
-        // frame.
-        goto next_frame;
-    }
-    if (offset >= registered_update_count) {
-        offset = 0;
+        ed_update_call(context, i, us_per_tick, &spent_us);
+        ++stats->update_funcs_overdue;
     }
-    if (offset == 0) {
-        chunk += registered_update_count % groups;
+
+    if (context->update_offset >= count) {
+        context->update_offset = 0;
     }
 
-    for (unsigned i = offset, chunk_end = offset + chunk; i < chunk_end; ++i) {
-        ed_node_update *node_update = &ed_update_funcs[i];
+    unsigned i = context->update_offset;
+    for (unsigned n = 0; n < count; ++n, i = (i + 1) % count) {
+        if (spent_us >= budget_us && stats->update_funcs_called > 0) {
+            break;
+        }
+
+        ed_node_update *node_update = &context->update_funcs[i];
+        if (node_update->last_frame == frame + 1) {
+            // Called as overdue above.
+            continue;
+        }
+        if (stats->update_funcs_called > 0
+                && spent_us + stats->update_cost_us[i] > budget_us) {
+            continue;
+        }
         if (node_update->node && !ed_is_visible(node_update->node)) {
-            // Hidden nodes are not updated.
             continue;
         }
-        if (node_update->update) node_update->update();
+
+        ed_update_call(context, i, us_per_tick, &spent_us);
+        context->update_offset = (i + 1) % count;
     }
-    offset += chunk;
 
-next_frame:
-    ++ed_stats.update_calls;
+    ++stats->update_calls;
     QueryPerformanceCounter(&end);
-    ed_stats.update_ticks = end.QuadPart - start.QuadPart;
+    stats->update_ticks = end.QuadPart - start.QuadPart;
 }
 
 // Set colors to the default system theme.
@@ -2244,10 +4504,10 @@ void
 ed_allocate_colors(void)
 {
     for (size_t color = 0; color < ED_COLOR_COUNT; ++color) {
-        if (brushes[color]) {
-            DeleteObject(brushes[color]);
+        if (ed_current->brushes[color]) {
+            DeleteObject(ed_current->brushes[color]);
         }
-        brushes[color] = CreateSolidBrush((COLORREF)ed_style.colors[color]);
+        ed_current->brushes[color] = CreateSolidBrush((COLORREF)ed_style.colors[color]);
     }
 }
 
@@ -2267,38 +4527,128 @@ ed_resize(void *hwnd)
     ed_invalidate(root);
 }
 
-// Lays out and draws a node.
+// Returns true if nothing outside of `node` moves when its children change
+// size, so it can be measured on its own.
+static bool
+ed_is_reflow_root(ed_node *node)
+{
+    return node->parent && node->rect.w != 0 && node->rect.h != 0
+        && !(node->flags & ED_COLLAPSED) && !node->scroll_bar;
+}
+
+// Marks a node to be measured again by the next `ed_invalidate` of the node
+// or one of its parents. Needed after changing `rect`, `flags` or other
+// layout fields of a node directly.
+//
+// Parents are marked up to the first one that is already marked, or whose
+// size does not depend on its children. Such a parent is queued and measured
+// on its own by the next `ed_invalidate` of it or one of its parents.
+void
+ed_mark_dirty(ed_node *node)
+{
+    node->dirty |= ED_DIRTY_MEASURE;
+    for (ed_node *p = node->parent; p && !(p->dirty & ED_DIRTY_CHILD); p = p->parent) {
+        p->dirty |= ED_DIRTY_CHILD;
+        if (ed_is_reflow_root(p)) {
+            if (!(p->dirty & ED_DIRTY_REFLOW)) {
+                ed_queue_push(&ed_current->reflow, p);
+                p->dirty |= ED_DIRTY_REFLOW;
+            }
+            break;
+        }
+    }
+}
+
+// Measures and lays out the nodes below `node` queued by `ed_mark_dirty`
+// which the measure of `node` did not reach. Adds the time taken to the
+// measure and layout ticks of the stats.
+static void
+ed_reflow(ed_node *node)
+{
+    struct ed_node_queue *queue = &ed_current->reflow;
+    LARGE_INTEGER start, end;
+
+    for (unsigned i = 0; i < queue->count;) {
+        ed_node *r = queue->nodes[i];
+        ed_node *p = r;
+        while (p && p != node) p = p->parent;
+        if (!p) {
+            ++i;
+            continue;
+        }
+
+        ed_unqueue_reflow(r);
+        if (!(r->dirty & ED_DIRTY_CHILD)) {
+            // Already measured with a parent.
+            continue;
+        }
+
+        ed_index_children(r->parent);
+        QueryPerformanceCounter(&start);
+        ed_measure(r, true);
+        QueryPerformanceCounter(&end);
+        ed_current->stats->measure_ticks += end.QuadPart - start.QuadPart;
+
+        QueryPerformanceCounter(&start);
+        ed_layout(r);
+        QueryPerformanceCounter(&end);
+        ed_current->stats->layout_ticks += end.QuadPart - start.QuadPart;
+    }
+}
+
+// Lays out and draws a node. The node itself is always measured again, but
+// its descendants are only measured if they were marked dirty with
+// `ed_mark_dirty` or the space available to them changed.
 void
 ed_invalidate(ed_node *node)
 {
     LARGE_INTEGER start, end;
 
+    node->dirty |= ED_DIRTY_MEASURE;
+    ed_current->stats->measured_nodes = 0;
+    ed_current->stats->measure_cache_lookups = 0;
+    ed_current->stats->measure_cache_hits = 0;
+    ed_current->stats->laid_out_nodes = 0;
+    ed_current->stats->native_calls_issued = 0;
+    ed_current->stats->native_calls_skipped = 0;
+    ed_current->stats->total_nodes = ed_current->active_node_count;
+
+    if (node->parent) {
+        ed_index_children(node->parent);
+    }
+
     QueryPerformanceCounter(&start);
-    ed_measure(node);
+    ed_measure(node, true);
     QueryPerformanceCounter(&end);
-    ed_stats.measure_ticks = end.QuadPart - start.QuadPart;
+    ed_current->stats->measure_ticks = end.QuadPart - start.QuadPart;
 
     QueryPerformanceCounter(&start);
     ed_layout(node);
     QueryPerformanceCounter(&end);
-    ed_stats.layout_ticks = end.QuadPart - start.QuadPart;
+    ed_current->stats->layout_ticks = end.QuadPart - start.QuadPart;
+
+    if (ed_current->reflow.count) {
+        ed_reflow(node);
+    }
 
-    InvalidateRect(ed_hwnd(node), NULL, TRUE);
-    ++ed_stats.invalidate_calls;
+    ++ed_current->stats->invalidate_calls;
 }
 
 // Updates the window text or image with the node value.
 void
 ed_invalidate_data(ed_node *node)
 {
-    if (node->value_type >= ED_VALUE_TYPE_SCALAR_MIN &&
-            node->value_type <= ED_VALUE_TYPE_SCALAR_MAX) {
+    ed_node_binding *binding = ed_binding(node);
+
+    if (binding->value_type >= ED_VALUE_TYPE_SCALAR_MIN &&
+            binding->value_type <= ED_VALUE_TYPE_SCALAR_MAX) {
         ed_invalidate_scalar(node);
-    } else if (node->value_type == ED_STRING) {
-        SetWindowTextA(ed_hwnd(node), (char *)node->value_ptr);
-    } else if (node->value_type == ED_DIB) {
+    } else if (binding->value_type == ED_STRING) {
+        ed_set_text_hash(binding);
+        SetWindowTextA(ed_hwnd(node), (char *)binding->value_ptr);
+    } else if (binding->value_type == ED_DIB) {
         InvalidateRect(ed_hwnd(node), NULL, TRUE);
-    } else if (node->value_type == ED_COLOR) {
+    } else if (binding->value_type == ED_COLOR) {
         InvalidateRect(ed_hwnd(node), NULL, TRUE);
     }
 }
@@ -2319,31 +4669,39 @@ ed_invalidate_data(ed_node *node)
 void
 ed_str_data(ed_node *node, void *value, size_t size)
 {
-    assert(node->type != ED_NONE
-            && "invalid node, it's possible this node was previously removed.");
+    // Data may span multiple nodes, only the first node should be passed to
+    // ed_data by the user. The rest of the value is passed along node_list.
+    for (;;) {
+        assert(node->type != ED_NONE
+                && "invalid node, it's possible this node was previously removed.");
+
+        ed_node_binding *binding = ed_binding(node);
+
+        if (binding->value_type >= ED_VALUE_TYPE_SCALAR_MIN &&
+                binding->value_type <= ED_VALUE_TYPE_SCALAR_MAX) {
+            ed_data_scalar(node, value, size);
+        } else if (binding->value_type == ED_STRING) {
+            ed_data_string(node, value, size);
+        } else if (binding->value_type == ED_DIB) {
+            ed_data_image(node, value);
+        } else if (binding->value_type == ED_COLOR) {
+            ed_data_color(node, value, size);
+        } else {
+            // Bitmaps and icons can only be initialized once, for a writable image
+            // buffer use ed_image_buffer (ED_BITMAPBUFFER) instead.
+            assert(!"node value type not supported by ed_data.");
+        }
 
-    if (node->value_type >= ED_VALUE_TYPE_SCALAR_MIN &&
-            node->value_type <= ED_VALUE_TYPE_SCALAR_MAX) {
-        ed_data_scalar(node, value, size);
-    } else if (node->value_type == ED_STRING) {
-        ed_data_string(node, value, size);
-    } else if (node->value_type == ED_DIB) {
-        ed_data_image(node, value);
-    } else if (node->value_type == ED_COLOR) {
-        ed_data_color(node, value, size);
-    } else {
-        // Bitmaps and icons can only be initialized once, for a writable image
-        // buffer use ed_image_buffer (ED_BITMAPBUFFER) instead.
-        assert(!"node value type not supported by ed_data.");
-    }
+        ++ed_current->stats->data_calls;
 
-    ++ed_stats.data_calls;
+        if (!binding->node_list) {
+            break;
+        }
 
-    if (node->node_list) {
-        // Data spans multiple nodes, only the first node should be passed to ed_data
-        // by the user.
-        assert(node->value_size);
-        ed_data(node->node_list, (char *)value + node->value_size);
+        assert(binding->value_size);
+        value = (char *)value + binding->value_size;
+        node = binding->node_list;
+        size = 0;
     }
 }
 
@@ -2356,6 +4714,225 @@ ed_data(ed_node *node, void *value)
     ed_str_data(node, value, 0);
 }
 
+// Binds the value of a node to `value` for `ed_sync`, which replaces calling
+// `ed_data` on the node every frame. If the data spans multiple nodes, every
+// node in `node_list` is bound to the next element. Binding a node again
+// replaces its value pointer.
+//
+// Only number, bool, enum, flags and color values can be bound, strings and
+// images are still passed to `ed_str_data`.
+void
+ed_bind(ed_node *node, void *value)
+{
+    struct ed_sync_table *table = &ed_current->sync;
+
+    for (; node; node = ed_binding(node)->node_list) {
+        assert(node->type != ED_NONE
+                && "invalid node, it's possible this node was previously removed.");
+
+        ed_node_binding *binding = ed_binding(node);
+        size_t size = 0;
+        switch (binding->value_type) {
+        case ED_INT:     size = sizeof(int); break;
+        case ED_FLOAT:   size = sizeof(float); break;
+        case ED_INT64:   size = sizeof(long long); break;
+        case ED_FLOAT64: size = sizeof(double); break;
+        case ED_ENUM:    size = sizeof(int); break;
+        case ED_FLAGS:   size = sizeof(int); break;
+        case ED_BOOL:    size = sizeof(bool); break;
+        case ED_COLOR:   size = 4 * sizeof(float); break;
+        default:
+            assert(!"node value type not supported by ed_bind.");
+        }
+
+        if (!binding->sync_slot) {
+            if (table->count == table->capacity) {
+                unsigned capacity = ed_max(2 * table->capacity, 64);
+                struct ed_sync_entry *entries = (struct ed_sync_entry *)realloc(
+                        table->entries, capacity * sizeof(struct ed_sync_entry));
+                assert(entries && "out of memory.");
+
+                table->entries = entries;
+                table->capacity = capacity;
+            }
+            binding->sync_slot = ++table->count;
+        }
+
+        struct ed_sync_entry *entry = &table->entries[binding->sync_slot - 1];
+        memset(entry, 0, sizeof(struct ed_sync_entry));
+        memcpy(entry->shadow, binding->value, size);
+        entry->value_ptr = value;
+        entry->id = node->id;
+        entry->size = (unsigned short)size;
+
+        // Like ed_data, a new value pointer refreshes the node even if the
+        // values are equal.
+        entry->stale = value != binding->value_ptr || size != binding->value_size;
+        ed_range_set(node, value, size);
+
+        value = (char *)value + size;
+    }
+}
+
+// Binds the value of a node to `value` for `ed_sync`, like `ed_bind`, but
+// compares only the version counter of the application. The value is passed
+// to `ed_str_data` when `*version` differs from the version seen by the last
+// sweep, so the cost of a sweep does not depend on the size of the data.
+// Strings, images and values spanning a `node_list` of any length can be
+// bound this way.
+//
+// size:
+//   Same as the size argument of `ed_str_data`.
+//
+// version:
+//   Counter owned by the application, incremented after each change to the
+//   data. Must stay valid until the node is removed or unbound.
+void
+ed_bind_version(ed_node *node, void *value, size_t size, const unsigned long long *version)
+{
+    assert(node->type != ED_NONE
+            && "invalid node, it's possible this node was previously removed.");
+
+    struct ed_sync_table *table = &ed_current->sync;
+    ed_node_binding *binding = ed_binding(node);
+
+    if (!binding->sync_block) {
+        if (table->block_count == table->block_capacity) {
+            unsigned capacity = ed_max(2 * table->block_capacity, 16);
+            struct ed_sync_block *blocks = (struct ed_sync_block *)realloc(
+                    table->blocks, capacity * sizeof(struct ed_sync_block));
+            assert(blocks && "out of memory.");
+
+            table->blocks = blocks;
+            table->block_capacity = capacity;
+        }
+        binding->sync_block = ++table->block_count;
+    }
+
+    struct ed_sync_block *block = &table->blocks[binding->sync_block - 1];
+    block->version = version;
+    block->seen = *version;
+    block->value_ptr = value;
+    block->size = size;
+    block->id = node->id;
+    block->stale = true;
+}
+
+// Removes the bindings of `ed_bind` and `ed_bind_version` from a node and the
+// rest of its `node_list`.
+void
+ed_unbind(ed_node *node)
+{
+    for (; node; node = ed_binding(node)->node_list) {
+        ed_node_binding *binding = ed_binding(node);
+        if (binding->sync_slot || binding->sync_block) {
+            ed_sync_remove(binding);
+        }
+    }
+}
+
+// Refreshes every node bound with `ed_bind` whose value changed since it was
+// last displayed, and every block bound with `ed_bind_version` whose version
+// moved. Call once per frame instead of `ed_data`.
+//
+// The sweep compares each value against a copy stored next to its pointer,
+// two 64-bit words at a time, without touching the node. Focus is queried once
+// per sweep and visibility only for changed values. As with `ed_data`, the
+// focused node and hidden nodes keep their displayed value until a later
+// sweep.
+void
+ed_sync(void)
+{
+    struct ed_sync_table *table = &ed_current->sync;
+    ed_current->stats->sync_compared = table->count + table->block_count;
+    ed_current->stats->sync_refreshed = 0;
+
+    for (unsigned i = 0; i < table->block_count; ++i) {
+        struct ed_sync_block *block = &table->blocks[i];
+        unsigned long long version = *block->version;
+        if (version == block->seen && !block->stale) {
+            continue;
+        }
+
+        ed_node *node = ed_index_node(block->id);
+        if (!ed_is_visible(node)) {
+            // Keep the version, the block is refreshed once it is shown.
+            continue;
+        }
+
+        block->seen = version;
+        block->stale = false;
+        ed_str_data(node, block->value_ptr, block->size);
+        ++ed_current->stats->sync_refreshed;
+    }
+
+    if (!table->count) {
+        return;
+    }
+
+    ed_node *focus = ed_get_focus();
+
+    for (unsigned i = 0; i < table->count; ++i) {
+        struct ed_sync_entry *entry = &table->entries[i];
+
+        unsigned long long current[2] = {0, 0};
+        memcpy(current, entry->value_ptr, entry->size);
+        if (!((current[0] ^ entry->shadow[0]) | (current[1] ^ entry->shadow[1]))
+                && !entry->stale) {
+            continue;
+        }
+
+        ed_node *node = ed_index_node(entry->id);
+        if (node == focus || !ed_is_visible(node)) {
+            continue;
+        }
+
+        ed_node_binding *binding = ed_binding(node);
+        binding->value_ptr = entry->value_ptr;
+        binding->value_size = entry->size;
+        entry->shadow[0] = current[0];
+        entry->shadow[1] = current[1];
+
+        if (!entry->stale && !memcmp(binding->value, current, entry->size)) {
+            // Already displayed by a call to ed_data.
+            continue;
+        }
+
+        entry->stale = false;
+        memcpy(binding->value, current, entry->size);
+        if (binding->value_type == ED_COLOR) {
+            InvalidateRect(ed_hwnd(node), NULL, TRUE);
+        } else {
+            ed_invalidate_scalar(node);
+        }
+        ++ed_current->stats->sync_refreshed;
+    }
+}
+
+// Same as `ed_str_data`, does nothing if the node was removed.
+void
+ed_handle_str_data(ed_handle handle, void *value, size_t size)
+{
+    ed_node *node = ed_resolve(handle);
+    if (node) ed_str_data(node, value, size);
+}
+
+// Same as `ed_data`, does nothing if the node was removed.
+void
+ed_handle_data(ed_handle handle, void *value)
+{
+    ed_node *node = ed_resolve(handle);
+    if (node) ed_data(node, value);
+}
+
+// Same as `ed_invalidate`, does nothing if the node was removed.
+void
+ed_handle_invalidate(ed_handle handle)
+{
+    ed_node *node = ed_resolve(handle);
+    if (node) ed_invalidate(node);
+}
+
 // Saves the current active parent and child, and sets the active parent to the
 // given node. The next control will be inserted after the last child of
 // `node`.
@@ -2368,16 +4945,16 @@ void
 ed_begin_context(ed_node *node)
 {
     assert(node);
-    assert(!ed_saved_ctx.parent
+    assert(!ed_current->saved_tree.parent
             && "expected ed_end_context before next call to ed_begin_context.");
 
-    ed_saved_ctx = ed_ctx;
-    ed_ctx.parent = node;
-    ed_ctx.child = node->child;
+    ed_current->saved_tree = ed_current->tree;
+    ed_current->tree.parent = node;
+    ed_current->tree.child = node->child;
 
-    if (ed_ctx.child) {
-        while (ed_ctx.child->after) {
-            ed_ctx.child = ed_ctx.child->after;
+    if (ed_current->tree.child) {
+        while (ed_current->tree.child->after) {
+            ed_current->tree.child = ed_current->tree.child->after;
         }
     }
 }
@@ -2386,14 +4963,14 @@ ed_begin_context(ed_node *node)
 void
 ed_end_context(void)
 {
-    assert(ed_saved_ctx.parent
+    assert(ed_current->saved_tree.parent
             && "expected ed_begin_context before ed_end_context.");
 
-    ed_invalidate(ed_ctx.parent);
+    ed_invalidate(ed_current->tree.parent);
 
-    ed_ctx.parent = ed_saved_ctx.parent;
-    ed_ctx.child = ed_saved_ctx.child;
-    memset(&ed_saved_ctx, 0, sizeof(ed_saved_ctx));
+    ed_current->tree.parent = ed_current->saved_tree.parent;
+    ed_current->tree.child = ed_current->saved_tree.child;
+    memset(&ed_current->saved_tree, 0, sizeof(ed_current->saved_tree));
 }
 
 // Sets the active child node to the given node. The next control created will
@@ -2404,8 +4981,51 @@ ed_insert_after(ed_node *node)
     assert(node);
     assert(node->parent && "cannot insert a new root node.");
 
-    ed_ctx.child = node;
-    ed_ctx.parent = node->parent;
+    ed_current->tree.child = node;
+    ed_current->tree.parent = node->parent;
+}
+
+// Frees `node` and all of its children. The subtree is walked in post-order
+// without recursion, so each node's links are read before the node is
+// released. Released nodes are only returned to their chunks once the whole
+// subtree has been visited, which is a single splice per chunk.
+static void
+ed_release_subtree(ed_node *node)
+{
+    struct ed_node_chunk *released_chunks = NULL;
+
+    ed_node *n = node;
+    while (n->child) n = n->child;
+
+    for (;;) {
+        ed_node *next = NULL;
+        if (n != node) {
+            if (n->after) {
+                next = n->after;
+                while (next->child) next = next->child;
+            } else {
+                next = n->parent;
+            }
+        }
+
+        ed_free_node_resources(n);
+
+        if (n == ed_current->color_picker.dialog) {
+            memset(&ed_current->color_picker, 0, sizeof ed_current->color_picker);
+        } else if (n == ed_current->color_picker.node) {
+            // The node being edited is gone, close the picker.
+            ed_hide(ed_current->color_picker.dialog);
+            ed_current->color_picker.node = NULL;
+            ed_current->color_picker.rgba = NULL;
+        }
+
+        ed_release_node(n, &released_chunks);
+
+        if (!next) break;
+        n = next;
+    }
+
+    ed_splice_released(released_chunks);
 }
 
 // Destroys a node window and removes the node from the UI tree.
@@ -2415,36 +5035,42 @@ ed_remove(ed_node *node)
     assert(node);
     assert(node->parent && "cannot remove root node.");
 
-    ed_free_node_resources(node);
-    --active_node_count;
+    ed_node *parent = node->parent;
 
-    if (ed_ctx.child == node) ed_ctx.child = node->before;
-    if (ed_ctx.parent == node) ed_ctx.parent = node->parent;
-
-    node->type = ED_NONE;
-    node->node_list = ed_ctx.removed;
-    ed_ctx.removed = node;
-
-    if (node->parent->type != ED_NONE) {
-        if (node->before) {
-            node->before->after = node->after;
-            if (node->after) {
-                node->after->before = node->before;
-            }
-        } else {
-            node->parent->child = node->after;
-            if (node->after) {
-                node->after->before = NULL;
-            }
+    // Move the active context out of the removed subtree.
+    for (ed_node *p = ed_current->tree.parent; p; p = p->parent) {
+        if (p == node) {
+            ed_current->tree.parent = parent;
+            ed_current->tree.child = node;
+            break;
         }
-
-        ed_destroy_node(node);
-        ed_invalidate(node->parent);
     }
+    if (ed_current->tree.child == node) ed_current->tree.child = node->before;
 
-    for (ed_node *c = node->child; c; c = c->after) {
-        ed_remove(c);
+    if (node->before) {
+        node->before->after = node->after;
+        if (node->after) {
+            node->after->before = node->before;
+        }
+    } else {
+        parent->child = node->after;
+        if (node->after) {
+            node->after->before = NULL;
+        }
     }
+
+    // Child windows are destroyed along with their parent.
+    ed_destroy_node(node);
+    ed_release_subtree(node);
+    ed_invalidate(parent);
+}
+
+// Same as `ed_remove`, does nothing if the node was already removed.
+void
+ed_handle_remove(ed_handle handle)
+{
+    ed_node *node = ed_resolve(handle);
+    if (node) ed_remove(node);
 }
 
 // Creates a window handle for a node.
@@ -2466,9 +5092,10 @@ ed_attach_hwnd(ed_node *node, const char *class_name, const char *name, int flag
             hmenu, NULL, NULL);
 
     SetWindowLongPtrA(ed_hwnd(node), GWLP_USERDATA, (LONG_PTR)node);
+    ed_set_window_context(ed_hwnd(node));
 
     if ((node->flags & ED_TEXTNODE) || node->type == ED_COMBOBOX) {
-        SendMessageA(ed_hwnd(node), WM_SETFONT, (WPARAM)ui_font, FALSE);
+        SendMessageA(ed_hwnd(node), WM_SETFONT, (WPARAM)ed_current->ui_font, FALSE);
     }
 }
 
@@ -2476,10 +5103,10 @@ ed_attach_hwnd(ed_node *node, const char *class_name, const char *name, int flag
 void
 ed_push_rect(float x, float y, float w, float h)
 {
-    assert(rect_stack_count < ARRAYSIZE(rect_stack));
+    assert(ed_current->rect_stack_count < ARRAYSIZE(ed_current->rect_stack));
     ed_rect rect = {x, y, w, h};
-    rect_stack[rect_stack_count] = rect;
-    ++rect_stack_count;
+    ed_current->rect_stack[ed_current->rect_stack_count] = rect;
+    ++ed_current->rect_stack_count;
 }
 
 // Removes and returns a rect from the rect stack. If the stack is empty a
@@ -2487,13 +5114,13 @@ ed_push_rect(float x, float y, float w, float h)
 ed_rect
 ed_pop_rect(float x, float y, float w, float h)
 {
-    if (rect_stack_count == 0) {
+    if (ed_current->rect_stack_count == 0) {
         ed_rect default_rect = {x, y, w, h};
         return default_rect;
     }
 
-    --rect_stack_count;
-    return rect_stack[rect_stack_count];
+    --ed_current->rect_stack_count;
+    return ed_current->rect_stack[ed_current->rect_stack_count];
 }
 
 // Creates a parent block.
@@ -2509,6 +5136,54 @@ ed_begin(ed_node_layout layout, float x, float y, float w, float h)
     return node;
 }
 
+// Creates a block placing its children in a grid of `column_count` columns,
+// filled row by row. Cells are placed in one pass without nested blocks, and
+// cells with w in (0, 1] are sized relative to the width of their column.
+//
+// weights:
+//   Width of each column, or NULL for columns of equal width. A weight in
+//   (0, 1] is a share of the width left after fixed columns and spacing,
+//   shares are normalized so they need not add up to 1. A larger weight is a
+//   width in pixels.
+ed_node *
+ed_begin_grid(int column_count, const float *weights, float x, float y, float w, float h)
+{
+    assert(column_count > 0 && "grid must have at least one column.");
+
+    struct ed_grid *grid = (struct ed_grid *)calloc(1, sizeof(struct ed_grid)
+            + column_count * sizeof(struct ed_grid_column));
+    assert(grid && "out of memory.");
+    grid->column_count = column_count;
+    grid->spacing = ed_style.spacing;
+    grid->columns = (struct ed_grid_column *)(grid + 1);
+
+    float share_total = 0.0f;
+    for (int i = 0; i < column_count; ++i) {
+        float weight = weights ? weights[i] : 1.0f;
+        if (weight > 1.0f) {
+            grid->columns[i].fixed_w = (int)weight;
+        } else {
+            grid->columns[i].share_w = weight;
+            share_total += weight;
+        }
+    }
+
+    for (int i = 0; i < column_count; ++i) {
+        struct ed_grid_column *col = &grid->columns[i];
+        if (share_total > 0.0f) col->share_w /= share_total;
+        if (i > 0) {
+            struct ed_grid_column *prev = &grid->columns[i - 1];
+            col->fixed_x = prev->fixed_x + prev->fixed_w;
+            col->share_x = prev->share_x + prev->share_w;
+        }
+        grid->fixed_w += col->fixed_w;
+    }
+
+    ed_node *node = ed_begin(ED_GRID, x, y, w, h);
+    ed_binding(node)->grid = grid;
+    return node;
+}
+
 // Creates a block with padding and an outline border.
 ed_node *
 ed_begin_border(ed_node_layout layout, float x, float y, float w, float h)
@@ -2544,10 +5219,62 @@ ed_begin_scroll(ed_node_layout layout)
     ed_attach_hwnd(scrollblock, "ED_WINDOW", NULL, WS_CHILD | WS_VISIBLE);
     ed_attach_hwnd(client, "ED_WINDOW", NULL, WS_CHILD | WS_VISIBLE);
     ed_attach_hwnd(scroll_bar, "SCROLLBAR", NULL, WS_CHILD | SBS_VERT);
-    ed_ctx.parent = client; // push client node
+    ed_current->tree.parent = client; // push client node
+    return scrollblock;
+}
+
+// Creates a virtual list, a vertical scroll block showing `row_count` rows of
+// the same height. Only the rows in view and a few rows around them are
+// created, and rows are bound again as they scroll into view. Returns the
+// scroll block.
+//
+// row_height:
+//   Height of each row in pixels.
+//
+// build:
+//   Called once for each row slot with the row as the active node, creates
+//   the controls of the row. May be NULL.
+//
+// bind:
+//   Called whenever a row slot shows a different row. `index` is the row shown
+//   by `row`.
+ed_node *
+ed_list(int row_count, float row_height, void (*build)(ed_node *row),
+        void (*bind)(ed_node *row, int index))
+{
+    assert(row_height >= 1.0f && "list rows must have a height in pixels.");
+    assert(bind && "list is missing a bind function.");
+
+    ed_node *scrollblock = ed_begin_scroll(ED_ABS);
+    ed_node *client = scrollblock->child;
+    client->flags |= ED_VIRTUALLIST;
+
+    struct ed_list *list = (struct ed_list *)calloc(1, sizeof(struct ed_list));
+    assert(list && "out of memory.");
+    list->row_count = row_count;
+    list->row_height = (int)row_height;
+    list->viewport_h = -1;
+    list->build = build;
+    list->bind = bind;
+    ed_binding(client)->list = list;
+
+    ed_pop();
     return scrollblock;
 }
 
+// Sets the number of rows of a list created with `ed_list`. Every row in view
+// is bound again.
+void
+ed_list_set_count(ed_node *node, int row_count)
+{
+    ed_node *client = node->child;
+    assert(client && (client->flags & ED_VIRTUALLIST) && "node is not a list.");
+
+    ed_binding(client)->list->row_count = row_count;
+    ed_list_update(client, true);
+    ed_invalidate(node);
+}
+
 // Creates a new child window with a title bar and vertical scroll bar.
 ed_node *
 ed_begin_window(const char *name, ed_node_layout layout, float x, float y, float w, float h)
@@ -2564,6 +5291,7 @@ ed_begin_window(const char *name, ed_node_layout layout, float x, float y, float
 
     ed_node *scrollblock = ed_begin_scroll(layout);
     scrollblock->flags |= ED_POPPARENT;
+    if (name) ed_set_name(node, name);
     return node;
 }
 
@@ -2584,7 +5312,8 @@ ed_begin_group(const char *name, ed_node_layout layout, float x, float y, float
 
     ed_attach_hwnd(node, "ED_WINDOW", name, WS_CHILD | WS_VISIBLE);
     ed_attach_hwnd(cap, "ED_CAPTION", name, WS_CHILD | WS_VISIBLE);
-    SetWindowSubclass(ed_hwnd(cap), ed_tabstop_proc, 1, 0);
+    SetWindowSubclass(ed_hwnd(cap), ed_tabstop_proc_in_context, 1, (DWORD_PTR)ed_current);
+    if (name) ed_set_name(node, name);
     return node;
 }
 
@@ -2598,11 +5327,11 @@ ed_begin_button(float x, float y, float w, float h, void (*onclick)(ed_node *nod
 {
     ed_node *node = ed_push(ED_BUTTON, x, y, w, h);
     node->flags = ED_TABSTOP;
-    node->onclick = onclick;
+    ed_binding(node)->onclick = onclick;
     node->spacing = ed_style.spacing;
 
     ed_attach_hwnd(node, "BUTTON", NULL, WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON);
-    SetWindowSubclass(ed_hwnd(node), ed_tabstop_proc, 1, 0);
+    SetWindowSubclass(ed_hwnd(node), ed_tabstop_proc_in_context, 1, (DWORD_PTR)ed_current);
     return node;
 }
 
@@ -2631,6 +5360,7 @@ ed_begin_hwnd(void *hwnd, ed_node_layout layout)
     }
 
     SetWindowLongPtrA(ed_hwnd(node), GWLP_USERDATA, (LONG_PTR)node);
+    ed_set_window_context(ed_hwnd(node));
     return node;
 }
 
@@ -2639,8 +5369,8 @@ void
 ed_end(void)
 {
     ed_pop();
-    if (ed_ctx.parent->id == ED_ID_ROOT) {
-        ed_invalidate(ed_ctx.parent);
+    if (ed_current->tree.parent->id == ED_ID_ROOT) {
+        ed_invalidate(ed_current->tree.parent);
     }
 }
 
@@ -2656,8 +5386,8 @@ ed_label(const char *label)
     node->flags = ED_TEXTNODE;
 
     ed_attach_hwnd(node, "STATIC", label, WS_CHILD | WS_VISIBLE | SS_CENTERIMAGE);
-    ed_measure_text_bounds(node);
-    SetWindowSubclass(ed_hwnd(node), ed_text_proc, 2, 0);
+    ed_measure_text_bounds(node, label);
+    SetWindowSubclass(ed_hwnd(node), ed_text_proc_in_context, 2, (DWORD_PTR)ed_current);
     return node;
 }
 
@@ -2671,13 +5401,13 @@ ed_button(const char *label, void (*onclick)(ed_node *node))
     ed_rect rect = ed_pop_rect(0, 0, 0, 0);
     ed_node *node = ed_attach(ED_BUTTON, rect.x, rect.y, rect.w, rect.h);
     node->flags = ED_BORDER | ED_TABSTOP | ED_TEXTNODE;
-    node->onclick = onclick;
+    ed_binding(node)->onclick = onclick;
     node->spacing = ed_style.spacing;
 
     ed_attach_hwnd(node, "BUTTON", label, WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON);
-    ed_measure_text_bounds(node);
-    SetWindowSubclass(ed_hwnd(node), ed_tabstop_proc, 1, 0);
-    SetWindowSubclass(ed_hwnd(node), ed_text_proc, 2, 0);
+    ed_measure_text_bounds(node, label);
+    SetWindowSubclass(ed_hwnd(node), ed_tabstop_proc_in_context, 1, (DWORD_PTR)ed_current);
+    SetWindowSubclass(ed_hwnd(node), ed_text_proc_in_context, 2, (DWORD_PTR)ed_current);
     return node;
 }
 
@@ -2685,11 +5415,12 @@ ed_button(const char *label, void (*onclick)(ed_node *node))
 ed_node *
 ed_space(float size)
 {
-    assert(ed_ctx.parent && ed_ctx.parent->layout != ED_ABS &&
+    assert(ed_current->tree.parent && ed_current->tree.parent->layout != ED_ABS &&
+            ed_current->tree.parent->layout != ED_GRID &&
             "space node can only be used with a horizontal or vertical layout.");
     ed_node *node;
 
-    if (ed_ctx.parent->layout == ED_VERT) {
+    if (ed_current->tree.parent->layout == ED_VERT) {
         node = ed_attach(ED_SPACE, 0, 0, 1.0f, size);
     } else {
         node = ed_attach(ED_SPACE, 0, 0, size, 1.0f);
@@ -2703,11 +5434,12 @@ ed_space(float size)
 ed_node *
 ed_separator(void)
 {
-    assert(ed_ctx.parent && ed_ctx.parent->layout != ED_ABS &&
+    assert(ed_current->tree.parent && ed_current->tree.parent->layout != ED_ABS &&
+            ed_current->tree.parent->layout != ED_GRID &&
             "separator node can only be used with a horizontal or vertical layout.");
     ed_node *node;
 
-    if (ed_ctx.parent->layout == ED_VERT) {
+    if (ed_current->tree.parent->layout == ED_VERT) {
         node = ed_attach(ED_SEPARATOR, 0, 0, 1.0f, 1.1f);
         node->spacing = ed_style.spacing;
         ed_attach_hwnd(node, "STATIC", "", WS_CHILD | WS_VISIBLE | SS_ETCHEDHORZ);
@@ -2754,8 +5486,9 @@ ed_node *
 ed_int(const char *label, int value_min, int value_max)
 {
     ed_node *node = ed_input(label, ED_INT);
-    ed_write_value(int, &node->value_min, &value_min);
-    ed_write_value(int, &node->value_max, &value_max);
+    ed_node_binding *binding = ed_binding(node);
+    ed_write_value(int, &binding->value_min, &value_min);
+    ed_write_value(int, &binding->value_max, &value_max);
 
     return node;
 }
@@ -2777,10 +5510,11 @@ ed_node *
 ed_int_fmt(const char *label, int value_min, int value_max, const char *fmt, int base)
 {
     ed_node *node = ed_input(label, ED_INT);
-    ed_write_value(int, &node->value_min, &value_min);
-    ed_write_value(int, &node->value_max, &value_max);
-    ed_write_value(int, &node->value[8], &base);
-    node->value_fmt = fmt;
+    ed_node_binding *binding = ed_binding(node);
+    ed_write_value(int, &binding->value_min, &value_min);
+    ed_write_value(int, &binding->value_max, &value_max);
+    ed_write_value(int, &binding->value[8], &base);
+    binding->value_fmt = fmt;
 
     return node;
 }
@@ -2793,8 +5527,9 @@ ed_node *
 ed_float(const char *label, float value_min, float value_max)
 {
     ed_node *node = ed_input(label, ED_FLOAT);
-    ed_write_value(float, &node->value_min, &value_min);
-    ed_write_value(float, &node->value_max, &value_max);
+    ed_node_binding *binding = ed_binding(node);
+    ed_write_value(float, &binding->value_min, &value_min);
+    ed_write_value(float, &binding->value_max, &value_max);
 
     return node;
 }
@@ -2807,8 +5542,9 @@ ed_node *
 ed_int64(const char *label, long long value_min, long long value_max)
 {
     ed_node *node = ed_input(label, ED_INT64);
-    ed_write_value(long long, &node->value_min, &value_min);
-    ed_write_value(long long, &node->value_max, &value_max);
+    ed_node_binding *binding = ed_binding(node);
+    ed_write_value(long long, &binding->value_min, &value_min);
+    ed_write_value(long long, &binding->value_max, &value_max);
 
     return node;
 }
@@ -2831,10 +5567,11 @@ ed_int64_fmt(const char *label, long long value_min, long long value_max,
         const char *fmt, int base)
 {
     ed_node *node = ed_input(label, ED_INT64);
-    ed_write_value(long long, &node->value_min, &value_min);
-    ed_write_value(long long, &node->value_max, &value_max);
-    ed_write_value(int, &node->value[8], &base);
-    node->value_fmt = fmt;
+    ed_node_binding *binding = ed_binding(node);
+    ed_write_value(long long, &binding->value_min, &value_min);
+    ed_write_value(long long, &binding->value_max, &value_max);
+    ed_write_value(int, &binding->value[8], &base);
+    binding->value_fmt = fmt;
 
     return node;
 }
@@ -2847,8 +5584,9 @@ ed_node *
 ed_float64(const char *label, double value_min, double value_max)
 {
     ed_node *node = ed_input(label, ED_FLOAT64);
-    ed_write_value(double, &node->value_min, &value_min);
-    ed_write_value(double, &node->value_max, &value_max);
+    ed_node_binding *binding = ed_binding(node);
+    ed_write_value(double, &binding->value_min, &value_min);
+    ed_write_value(double, &binding->value_max, &value_max);
 
     return node;
 }
@@ -2866,15 +5604,16 @@ ed_enum(const char *label, const char **items, size_t items_count)
 
     ed_node *node = ed_attach(ED_COMBOBOX, 0, 0, 1.0f - ed_style.label_width, 0);
     node->flags = ED_TABSTOP;
-    node->value_type = ED_ENUM;
-    node->bounds.h = (short)(ed_style.label_height * items_count);
+    ed_node_binding *binding = ed_binding(node);
+    binding->value_type = ED_ENUM;
+    node->bounds.h = (int)(ed_style.label_height * items_count);
 
     int value = -1;
-    ed_write_value(int, &node->value, &value);
+    ed_write_value(int, &binding->value, &value);
     ed_end();
 
     ed_attach_hwnd(node, "COMBOBOX", label, WS_CHILD | WS_VISIBLE | CBS_DROPDOWNLIST);
-    SetWindowSubclass(ed_hwnd(node), ed_tabstop_proc, 1, 0);
+    SetWindowSubclass(ed_hwnd(node), ed_tabstop_proc_in_context, 1, (DWORD_PTR)ed_current);
 
     for (size_t i = 0; i < items_count; ++i) {
         SendMessageA(ed_hwnd(node), CB_ADDSTRING, 0, (LPARAM)items[i]);
@@ -2895,16 +5634,17 @@ ed_flags(const char *label, const char **items, size_t items_count)
 
     ed_node *node = ed_attach(ED_COMBOBOX, 0, 0, 1.0f - ed_style.label_width, 0);
     node->flags = ED_TABSTOP;
-    node->value_type = ED_FLAGS;
-    node->bounds.h = (short)(ed_style.label_height * items_count);
+    ed_node_binding *binding = ed_binding(node);
+    binding->value_type = ED_FLAGS;
+    node->bounds.h = (int)(ed_style.label_height * items_count);
 
     int value = 0;
-    ed_write_value(int, &node->value, &value);
+    ed_write_value(int, &binding->value, &value);
     ed_end();
 
     ed_attach_hwnd(node, "COMBOBOX", label,
             WS_CHILD | WS_VISIBLE | CBS_DROPDOWNLIST | CBS_OWNERDRAWFIXED);
-    SetWindowSubclass(ed_hwnd(node), ed_tabstop_proc, 1, 0);
+    SetWindowSubclass(ed_hwnd(node), ed_tabstop_proc_in_context, 1, (DWORD_PTR)ed_current);
 
     for (size_t i = 0; i < items_count; ++i) {
         SendMessageA(ed_hwnd(node), CB_ADDSTRING, 0, (LPARAM)items[i]);
@@ -2926,12 +5666,13 @@ ed_bool(const char *label)
 
     ed_node *node = ed_attach(ED_CHECKBOX, 0, 0, 1.0f - ed_style.label_width, 0);
     node->flags = ED_TABSTOP;
-    node->value_type = ED_BOOL;
-    memset(&node->value, BST_INDETERMINATE, 1);
+    ed_node_binding *binding = ed_binding(node);
+    binding->value_type = ED_BOOL;
+    memset(&binding->value, BST_INDETERMINATE, 1);
     ed_end();
 
     ed_attach_hwnd(node, "BUTTON", NULL, WS_CHILD | WS_VISIBLE | BS_3STATE);
-    SetWindowSubclass(ed_hwnd(node), ed_tabstop_proc, 1, 0);
+    SetWindowSubclass(ed_hwnd(node), ed_tabstop_proc_in_context, 1, (DWORD_PTR)ed_current);
     SendMessageA(ed_hwnd(node), BM_SETCHECK, BST_INDETERMINATE, 0);
 
     return node;
@@ -2951,17 +5692,18 @@ ed_text(const char *label)
 
     ed_node *node = ed_attach(ED_INPUT, 0, 0, 1.0f, 1.0f);
     node->flags = ED_TABSTOP | ED_TEXTNODE;
-    node->value_type = ED_STRING;
+    ed_node_binding *binding = ed_binding(node);
+    binding->value_type = ED_STRING;
     node->spacing = ed_style.spacing;
     ed_end();
 
     ed_attach_hwnd(node, "EDIT", "", WS_CHILD | WS_VISIBLE | WS_VSCROLL
             | WS_BORDER | ES_AUTOVSCROLL | ES_MULTILINE | ES_WANTRETURN);
 
-    SetWindowSubclass(ed_hwnd(node), ed_edit_proc, 0, 0);
-    SetWindowSubclass(ed_hwnd(node), ed_tabstop_proc, 1, 0);
+    SetWindowSubclass(ed_hwnd(node), ed_edit_proc_in_context, 0, (DWORD_PTR)ed_current);
+    SetWindowSubclass(ed_hwnd(node), ed_tabstop_proc_in_context, 1, (DWORD_PTR)ed_current);
 
-    ed_data(node, node->value);
+    ed_data(node, binding->value);
     return node;
 }
 
@@ -3004,11 +5746,10 @@ ed_vector(const char *label, ed_value_type value_type, size_t n)
         ed_push_rect(0, 0, ed_style.label_width, ed_style.label_height);
         ed_label(label);
     }
-    ed_begin(ED_VERT, 0, 0, 1.0f, 0);
+    float weights[2] = {item_label_width, 1.0f};
+    ed_begin_grid(2, weights, 0, 0, 1.0f, 0);
 
     for (size_t i = 0; i < n; ++i) {
-        ed_begin(ED_HORZ, 0, 0, 1.0f, 0);
-
         if (n < ARRAYSIZE(item_labels)) {
             ed_push_rect(0, 0, item_label_width, ed_style.label_height);
             ed_label(item_labels[i]);
@@ -3025,10 +5766,9 @@ ed_vector(const char *label, ed_value_type value_type, size_t n)
             first = node;
             last = node;
         } else {
-            last->node_list = node;
+            ed_binding(last)->node_list = node;
             last = node;
         }
-        ed_end();
     }
 
     ed_end();
@@ -3065,24 +5805,28 @@ ed_matrix(const char *label, ed_value_type value_type, size_t m, size_t n)
         ed_label(label);
     }
 
-    float input_w = 1.0f / (float)n;
-    ed_begin(ED_HORZ, rect.x, rect.y, rect.w, rect.h);
-    for (size_t i = 0; i < n; ++i) {
-        ed_begin(ED_VERT, 0, 0, input_w, 0)->spacing = ed_style.spacing;
-        for (size_t j = 0; j < m; ++j) {
+    // Cells are created row by row, the node list is chained column by column.
+    ed_node **cells = (ed_node **)malloc(m * n * sizeof(ed_node *));
+    assert((cells || m * n == 0) && "out of memory.");
+
+    ed_begin_grid((int)n, NULL, rect.x, rect.y, rect.w, rect.h);
+    for (size_t j = 0; j < m; ++j) {
+        for (size_t i = 0; i < n; ++i) {
             ed_push_rect(0, 0, 1.0f, ed_style.input_height);
-            ed_node *node = ed_input_basic(value_type);
+            cells[i * m + j] = ed_input_basic(value_type);
+        }
+    }
 
-            if (first) {
-                last->node_list = node;
-                last = node;
-            } else {
-                first = node;
-                last = node;
-            }
+    for (size_t k = 0; k < m * n; ++k) {
+        if (first) {
+            ed_binding(last)->node_list = cells[k];
+            last = cells[k];
+        } else {
+            first = cells[k];
+            last = cells[k];
         }
-        ed_end();
     }
+    free(cells);
 
     ed_end();
     ed_end();
@@ -3118,23 +5862,20 @@ ed_matrix_row(const char *label, ed_value_type value_type, size_t m, size_t n)
         ed_label(label);
     }
 
-    float input_w = 1.0f / (float)m;
-    ed_begin(ED_VERT, rect.x, rect.y, rect.w, rect.h);
+    ed_begin_grid((int)m, NULL, rect.x, rect.y, rect.w, rect.h);
     for (size_t i = 0; i < n; ++i) {
-        ed_begin(ED_HORZ, 0, 0, 1.0f, 0);
         for (size_t j = 0; j < m; ++j) {
-            ed_push_rect(0, 0, input_w, ed_style.input_height);
+            ed_push_rect(0, 0, 1.0f, ed_style.input_height);
             ed_node *node = ed_input_basic(value_type);
 
             if (first) {
-                last->node_list = node;
+                ed_binding(last)->node_list = node;
                 last = node;
             } else {
                 first = node;
                 last = node;
             }
         }
-        ed_end();
     }
 
     ed_end();
@@ -3160,11 +5901,12 @@ ed_color(const char *label)
     ed_node *node = ed_attach(ED_BUTTON, 0, 0, 1.0f, ed_style.input_height);
     node->spacing = ed_style.spacing;
     node->flags = ED_TABSTOP;
-    node->value_type = ED_COLOR;
-    node->value_ptr = node->value;
+    ed_node_binding *binding = ed_binding(node);
+    binding->value_type = ED_COLOR;
+    binding->value_ptr = binding->value;
 
     ed_attach_hwnd(node, "ED_COLOR", "", WS_CHILD | WS_VISIBLE);
-    SetWindowSubclass(ed_hwnd(node), ed_tabstop_proc, 1, 0);
+    SetWindowSubclass(ed_hwnd(node), ed_tabstop_proc_in_context, 1, (DWORD_PTR)ed_current);
 
     ed_end();
     return node;
@@ -3172,7 +5914,7 @@ ed_color(const char *label)
 
 // Creates a static image node by loading a .bmp or .ico image from a file.
 //
-// `node->value_ptr` points to the created HBITMAP or HICON.
+// `ed_binding(node)->value_ptr` points to the created HBITMAP or HICON.
 //
 // filename:
 //   Bitmap (.bmp) or icon (.ico) file. The image type is determined from the
@@ -3186,12 +5928,14 @@ ed_image(const char *filename)
     node->flags = ED_OWNDATA;
     ed_load_image(node, filename);
 
-    if (node->value_type == ED_ICON) {
+    ed_node_binding *binding = ed_binding(node);
+
+    if (binding->value_type == ED_ICON) {
         ed_attach_hwnd(node, "STATIC", NULL, WS_CHILD | WS_VISIBLE | SS_ICON);
-        SendMessageA(ed_hwnd(node), STM_SETIMAGE, IMAGE_ICON, (LPARAM)node->value_ptr);
+        SendMessageA(ed_hwnd(node), STM_SETIMAGE, IMAGE_ICON, (LPARAM)binding->value_ptr);
     } else {
         ed_attach_hwnd(node, "STATIC", NULL, WS_CHILD | WS_VISIBLE | SS_BITMAP);
-        SendMessageA(ed_hwnd(node), STM_SETIMAGE, IMAGE_BITMAP, (LPARAM)node->value_ptr);
+        SendMessageA(ed_hwnd(node), STM_SETIMAGE, IMAGE_BITMAP, (LPARAM)binding->value_ptr);
     }
 
     return node;
@@ -3201,7 +5945,7 @@ ed_image(const char *filename)
 // passing the new buffer to `ed_data`. The modified buffer must be the same
 // dimensions and format of the allocated buffer.
 //
-// `node->value_ptr` points to the created HBITMAP.
+// `ed_binding(node)->value_ptr` points to the created HBITMAP.
 //
 // image:
 //   A buffer with format `fmt` or NULL. The size of the buffer must be
@@ -3228,7 +5972,7 @@ ed_image_buffer(const unsigned char *image, int w, int h, ed_pixel_format fmt)
     ed_node *node = ed_attach(ED_IMAGE, rect.x, rect.y, rect.w, rect.h);
     node->spacing = ed_style.spacing;
     node->flags = ED_OWNDATA;
-    node->value_type = ED_DIB;
+    ed_binding(node)->value_type = ED_DIB;
     ed_alloc_bitmap_buffer(node, image, w, h, fmt);
 
     ed_attach_hwnd(node, "ED_IMAGE", NULL, WS_CHILD | WS_VISIBLE);
@@ -3238,7 +5982,7 @@ ed_image_buffer(const unsigned char *image, int w, int h, ed_pixel_format fmt)
 // Creates a static image button node by loading a .bmp or .ico image from a
 // file.
 //
-// `node->value_ptr` points to the created HBITMAP or HICON.
+// `ed_binding(node)->value_ptr` points to the created HBITMAP or HICON.
 //
 // filename:
 //   Bitmap (.bmp) or icon (.ico) file. The image type is determined from the
@@ -3248,22 +5992,23 @@ ed_image_button(const char *filename, void (*onclick)(ed_node *node))
 {
     ed_rect rect = ed_pop_rect(0, 0, 0, 0);
     ed_node *node = ed_attach(ED_BUTTON, rect.x, rect.y, rect.w, rect.h);
-    node->onclick = onclick;
+    ed_node_binding *binding = ed_binding(node);
+    binding->onclick = onclick;
     node->spacing = ed_style.spacing;
     node->flags = ED_OWNDATA | ED_TABSTOP;
     ed_load_image(node, filename);
 
-    if (node->value_type == ED_ICON) {
+    if (binding->value_type == ED_ICON) {
         ed_attach_hwnd(node, "BUTTON", NULL,
                 WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON | BS_ICON);
-        SendMessageA(ed_hwnd(node), BM_SETIMAGE, IMAGE_ICON, (LPARAM)node->value_ptr);
+        SendMessageA(ed_hwnd(node), BM_SETIMAGE, IMAGE_ICON, (LPARAM)binding->value_ptr);
     } else {
         ed_attach_hwnd(node, "BUTTON", NULL,
                 WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON | BS_BITMAP);
-        SendMessageA(ed_hwnd(node), BM_SETIMAGE, IMAGE_BITMAP, (LPARAM)node->value_ptr);
+        SendMessageA(ed_hwnd(node), BM_SETIMAGE, IMAGE_BITMAP, (LPARAM)binding->value_ptr);
     }
 
-    SetWindowSubclass(ed_hwnd(node), ed_tabstop_proc, 1, 0);
+    SetWindowSubclass(ed_hwnd(node), ed_tabstop_proc_in_context, 1, (DWORD_PTR)ed_current);
     return node;
 }
 
@@ -3280,11 +6025,12 @@ ed_image_buffer_copy(ed_node *node, const unsigned char *src)
 {
     const float one_over_255 = 1.0f / 255.0f;
 
-    assert(node->value_type == ED_DIB);
-    assert(node->value_dib_image);
+    ed_node_binding *binding = ed_binding(node);
+    assert(binding->value_type == ED_DIB);
+    assert(binding->value_dib_image);
 
-    ed_bitmap_buffer buffer = ed_read_value(ed_bitmap_buffer, node->value);
-    unsigned char *dst = node->value_dib_image;
+    ed_bitmap_buffer buffer = ed_read_value(ed_bitmap_buffer, binding->value);
+    unsigned char *dst = binding->value_dib_image;
     size_t buffer_size = buffer.w * buffer.h * ED_BITMAP_BYTESPERPIXEL;
 
     switch (buffer.fmt) {
@@ -3355,11 +6101,12 @@ void
 ed_image_buffer_clear(ed_node *node,
         unsigned char r, unsigned char g, unsigned char b, unsigned char a)
 {
-    assert(node->value_type == ED_DIB);
-    assert(node->value_dib_image);
+    ed_node_binding *binding = ed_binding(node);
+    assert(binding->value_type == ED_DIB);
+    assert(binding->value_dib_image);
 
-    ed_bitmap_buffer buffer = ed_read_value(ed_bitmap_buffer, node->value);
-    unsigned int *dst = (unsigned int *)node->value_dib_image;
+    ed_bitmap_buffer buffer = ed_read_value(ed_bitmap_buffer, binding->value);
+    unsigned int *dst = (unsigned int *)binding->value_dib_image;
     size_t buffer_size_pixels = buffer.w * buffer.h;
 
     float af = a / 255.0f;
@@ -3443,10 +6190,10 @@ ed_set_focus(ed_node *node)
         if (client->scroll_bar) {
             if (rect.top < 0) {
                 int delta = rect.top - ed_style.spacing;
-                ed_set_scroll_position(client, client->scroll_pos + delta);
+                ed_set_scroll_position(client, ed_scroll_offset(client) + delta);
             } else if (rect.bottom > client->dst.h) {
                 int delta = (rect.bottom + ed_style.spacing) - client->dst.h;
-                ed_set_scroll_position(client, client->scroll_pos + delta);
+                ed_set_scroll_position(client, ed_scroll_offset(client) + delta);
             }
         }
     }
@@ -3474,6 +6221,8 @@ void
 ed_show(ed_node *node)
 {
     ShowWindow(ed_hwnd(node), SW_SHOW);
+    node->flags &= ~ED_HIDDEN;
+    ed_mark_dirty(node);
 }
 
 // Hides a window. The state of the window can be queried with IsWindowVisible.
@@ -3481,6 +6230,8 @@ void
 ed_hide(ed_node *node)
 {
     ShowWindow(ed_hwnd(node), SW_HIDE);
+    node->flags |= ED_HIDDEN;
+    ed_mark_dirty(node);
 }
 
 // Enables the node and its children. The state of the window can be queried
@@ -3488,9 +6239,8 @@ ed_hide(ed_node *node)
 void
 ed_enable(ed_node *node)
 {
-    EnableWindow(ed_hwnd(node), TRUE);
-    for (ed_node *c = node->child; c; c = c->after) {
-        ed_enable(c);
+    for (ed_node *n = node; n; n = ed_preorder_next(n, node)) {
+        EnableWindow(ed_hwnd(n), TRUE);
     }
 }
 
@@ -3499,12 +6249,43 @@ ed_enable(ed_node *node)
 void
 ed_disable(ed_node *node)
 {
-    EnableWindow(ed_hwnd(node), FALSE);
-    for (ed_node *c = node->child; c; c = c->after) {
-        ed_disable(c);
+    for (ed_node *n = node; n; n = ed_preorder_next(n, node)) {
+        EnableWindow(ed_hwnd(n), FALSE);
     }
 }
 
+// Same as `ed_show`, does nothing if the node was removed.
+void
+ed_handle_show(ed_handle handle)
+{
+    ed_node *node = ed_resolve(handle);
+    if (node) ed_show(node);
+}
+
+// Same as `ed_hide`, does nothing if the node was removed.
+void
+ed_handle_hide(ed_handle handle)
+{
+    ed_node *node = ed_resolve(handle);
+    if (node) ed_hide(node);
+}
+
+// Same as `ed_enable`, does nothing if the node was removed.
+void
+ed_handle_enable(ed_handle handle)
+{
+    ed_node *node = ed_resolve(handle);
+    if (node) ed_enable(node);
+}
+
+// Same as `ed_disable`, does nothing if the node was removed.
+void
+ed_handle_disable(ed_handle handle)
+{
+    ed_node *node = ed_resolve(handle);
+    if (node) ed_disable(node);
+}
+
 // Expands a collapsed node by making all of its children visible.
 //
 // node:
@@ -3519,8 +6300,10 @@ ed_expand(ed_node *node)
     if (node->child) {
         for (ed_node *c = node->child->after; c; c = c->after) {
             ShowWindow(ed_hwnd(c), SW_SHOW);
+            c->flags &= ~ED_HIDDEN;
         }
 
+        ed_mark_dirty(node);
         ed_invalidate(node->parent);
     }
 }
@@ -3539,8 +6322,10 @@ ed_collapse(ed_node *node)
     if (node->child) {
         for (ed_node *c = node->child->after; c; c = c->after) {
             ShowWindow(ed_hwnd(c), SW_HIDE);
+            c->flags |= ED_HIDDEN;
         }
 
+        ed_mark_dirty(node);
         ed_invalidate(node->parent);
     }
 }
@@ -3550,11 +6335,9 @@ ed_collapse(ed_node *node)
 void
 ed_readonly(ed_node *node)
 {
-    node->flags |= ED_READONLY;
-    SendMessageA(ed_hwnd(node), EM_SETREADONLY, TRUE, 0);
-
-    if (node->node_list) {
-        ed_readonly(node->node_list);
+    for (; node; node = ed_binding(node)->node_list) {
+        node->flags |= ED_READONLY;
+        SendMessageA(ed_hwnd(node), EM_SETREADONLY, TRUE, 0);
     }
 }
 
@@ -3563,11 +6346,9 @@ ed_readonly(ed_node *node)
 void
 ed_readwrite(ed_node *node)
 {
-    node->flags &= ~ED_READONLY;
-    SendMessageA(ed_hwnd(node), EM_SETREADONLY, FALSE, 0);
-
-    if (node->node_list) {
-        ed_readwrite(node->node_list);
+    for (; node; node = ed_binding(node)->node_list) {
+        node->flags &= ~ED_READONLY;
+        SendMessageA(ed_hwnd(node), EM_SETREADONLY, FALSE, 0);
     }
 }
 
@@ -6,12 +6,10 @@
 
 #define ED_VERSION 2302
 
-#ifndef ED_TREE_MEMORY
-#define ED_TREE_MEMORY (1024 << 10)
-#endif
-
-#ifndef ED_NODE_COUNT
-#define ED_NODE_COUNT (ED_TREE_MEMORY / sizeof(ed_node))
+// Number of nodes allocated at a time. The node tree grows by one chunk
+// whenever all existing chunks are full.
+#ifndef ED_TREE_CHUNK_SIZE
+#define ED_TREE_CHUNK_SIZE 256
 #endif
 
 #ifndef ED_RECT_STACK_SIZE
@@ -24,6 +22,13 @@
 
 #define ED_ID_ROOT 1
 
+// A handle is a node slot index in the low bits and a generation in the high
+// bits.
+#define ED_HANDLE_NULL 0
+#define ED_HANDLE_INDEX_BITS 22
+#define ED_HANDLE_INDEX_MASK ((1u << ED_HANDLE_INDEX_BITS) - 1)
+#define ED_HANDLE_GENERATION_MASK ((1u << (32 - ED_HANDLE_INDEX_BITS)) - 1)
+
 #define ED_BITMAP_BYTESPERPIXEL 4
 #define ED_BITMAP_BITSPERPIXEL 32
 
@@ -36,6 +41,7 @@ typedef enum ed_node_layout {
     ED_VERT,
     ED_HORZ,
     ED_ABS,
+    ED_GRID,  // Rows of cells in fixed columns, see `ed_begin_grid`
 } ed_node_layout;
 
 typedef enum ed_node_type {
@@ -93,6 +99,10 @@ enum ed_node_flags {
     ED_TABSTOP     = 0x00000100,
     ED_OWNDATA     = 0x00000200,
     ED_OWNUPDATE   = 0x00000400,
+    ED_OVERFLOW    = 0x00000800,
+    ED_VIRTUALLIST = 0x00001000,
+    ED_DATAPENDING = 0x00002000,
+    ED_HIDDEN      = 0x00004000,
 };
 
 enum ed_color {
@@ -156,38 +166,87 @@ typedef struct ed_rect {
     float x, y, w, h;
 } ed_rect;
 
+// Layout coordinates are 32-bit so scroll content may be taller than the
+// 16-bit range of native window coordinates.
 typedef struct ed_dst {
-    short x, y, w, h;
+    int x, y, w, h;
 } ed_dst;
 
 typedef struct ed_bounds {
-    short w, h;
+    int w, h;
 } ed_bounds;
 
+// An independent UI tree with its own nodes, fonts, brushes and update
+// functions. See `ed_set_context`.
+typedef struct ed_context ed_context;
+
+// Handle to a node which can be kept across frames. Once the node is removed
+// the handle no longer resolves, even if the node slot is reused.
+typedef unsigned ed_handle;
+
 typedef struct ed_bitmap_buffer {
     ed_pixel_format fmt;
     short w, h;
 } ed_bitmap_buffer;
 
+// Applies the window geometry computed by the layout, see `ed_set_backend`.
+// Every call to ed_layout that changes a window ends in one commit:
+// begin_commit, then one group for each parent window with changed children,
+// then end_commit. A layout that changes nothing calls no backend function.
+typedef struct ed_backend {
+    void *user;
+
+    // Called around every commit with the window of the node laid out. Redraw
+    // may be suppressed until end_commit, which redraws the window once.
+    void (*begin_commit)(void *user, void *hwnd);
+    void (*end_commit)(void *user, void *hwnd);
+
+    // Called around the changes to the children of `parent`. `count` is the
+    // number of calls to set_geometry in the group.
+    void (*begin_group)(void *user, void *parent, int count);
+    void (*end_group)(void *user, void *parent);
+
+    // Moves and shows a window, or hides it if `visible` is false.
+    void (*set_geometry)(void *user, void *hwnd, int x, int y, int w, int h, bool visible);
+
+    // Sets the range and position of a scrollbar. Called outside of groups.
+    void (*set_scroll)(void *user, void *hwnd, int max, int page, int pos);
+} ed_backend;
+
+// Tree and layout data of a node. Only fields read by the measure and layout
+// passes are stored here so those passes walk dense memory. Value data is kept
+// in a separate table, see `ed_binding`.
 typedef struct ed_node {
     struct ed_node *parent, *child;
     struct ed_node *before, *after;
 
     void *hwnd;            // Window handle
 
-    short id;
-    short scroll_pos;      // For scroll clients, position of vertical scrollbar
-    short spacing, padding;
+    int id;
+    int scroll_pos;        // For scroll clients, position of vertical scrollbar
+    int spacing, padding;
 
     ed_rect rect;          // User specified position and size, may be relative to parent
     ed_dst dst;            // Final window position and size
     ed_bounds bounds;      // Space required by children, may be larger than dst
+    ed_dst committed;      // Window rectangle applied by the last commit
+    int measured_w;        // Size of dst when children were last measured
+    int measured_h;
+    int measure_axes;      // Axes of dst the children depended on when last measured
+    int dirty;             // Parts of the node that must be measured or laid out again
+    int child_count;       // Number of children when the node was last measured
+    int child_index;       // Position of the node among its siblings
     ed_node_layout layout;
     ed_node_type type;
     int flags;
 
-    short scroll_bar;      // For scroll clients, id of scrollbar node
-    short scroll_client;   // For scrollbars, id of client node
+    int scroll_bar;        // For scroll clients, id of scrollbar node
+    int scroll_client;     // For scrollbars, id of client node
+} ed_node;
+
+// Value and binding data of a node. Stored in a table parallel to the node
+// tree and indexed by node id.
+typedef struct ed_node_binding {
     ed_value_type value_type;
 
     char value[16];        // Current number value displayed, size of string buffer, or bitmap buffer
@@ -212,11 +271,24 @@ typedef struct ed_node {
     };
 
     void *user_data;
-} ed_node;
+
+    ed_handle handle;      // Handle given out by ed_get_handle, or ED_HANDLE_NULL
+    char *name;            // Name set with ed_set_name, or NULL
+    unsigned name_hash;    // Hash of name and scope in the name index
+    struct ed_list *list;  // Rows of a virtual list client, or NULL
+    struct ed_grid *grid;  // Columns of an ED_GRID block, or NULL
+    int committed_scroll[3]; // Scrollbar range, page and position set last
+    unsigned sync_slot;    // 1 + index of the entry added by ed_bind, or 0
+    unsigned sync_block;   // 1 + index of the block added by ed_bind_version, or 0
+    unsigned range_slot;   // 1 + index of the value_ptr range for ed_notify_range, or 0
+    unsigned long long text_hash; // For strings, hash of the text last set on the window
+    size_t text_length;    // Length + 1 of that text, 0 if the window text is unknown
+} ed_node_binding;
 
 typedef struct ed_node_update {
     ed_node *node;
     void (*update)(void);
+    unsigned last_frame;   // ed_stats.update_calls after the frame the function last ran
 } ed_node_update;
 
 struct ed_stats {
@@ -237,33 +309,102 @@ struct ed_stats {
     // during the last call to ed_invalidate.
     long long layout_ticks;
 
+    // Number of nodes measured and laid out during the last call to
+    // ed_invalidate, and the number of nodes in the tree at the time.
+    unsigned measured_nodes;
+    unsigned laid_out_nodes;
+    unsigned total_nodes;
+
+    // Number of clean nodes with children reached during the last call to
+    // ed_invalidate, and how many of them reused the measure of their
+    // children. The hit rate of the measure cache is hits / lookups.
+    unsigned measure_cache_lookups;
+    unsigned measure_cache_hits;
+
+    // Number of native window calls made and skipped because their arguments
+    // matched the last commit during the last call to ed_invalidate.
+    unsigned native_calls_issued;
+    unsigned native_calls_skipped;
+
     // Number of ticks (from QueryPerformanceCounter) used by calls to ed_data
     // during the last call to ed_update.
     long long update_ticks;
+
+    // Number of bound values and versions compared, and of nodes and
+    // versioned blocks refreshed during the last call to ed_sync.
+    unsigned sync_compared;
+    unsigned sync_refreshed;
+
+    // Number of nodes marked by ed_notify_range and refreshed during the last
+    // call to ed_update.
+    unsigned notify_refreshed;
+
+    // Moving average of the time in microseconds taken by each update
+    // function, indexed like `ed_update_funcs`. Updated by ed_update_budget.
+    float update_cost_us[ED_UPDATE_FUNCS_COUNT];
+
+    // Number of update functions called during the last call to
+    // ed_update_budget, and how many of them were called regardless of the
+    // budget because they had waited too many frames.
+    unsigned update_funcs_called;
+    unsigned update_funcs_overdue;
+
+    // Number of calls to ed_compact.
+    unsigned compact_calls;
+
+    // Fraction of nodes not stored in depth-first order before and after the
+    // last call to ed_compact.
+    float fragmentation_before;
+    float fragmentation_after;
 };
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-ed_node *ed_index_node(short id);
+ed_node *ed_index_node(int id);
+ed_node_binding *ed_binding(ed_node *node);
+ed_handle ed_get_handle(ed_node *node);
+ed_node *ed_resolve(ed_handle handle);
+void ed_compact(void);
+float ed_fragmentation(void);
+void ed_set_name(ed_node *node, const char *name);
+ed_node *ed_find(const char *path);
 void ed_init(void *hwnd);
 void ed_deinit(void);
+ed_context *ed_create_context(void);
+void ed_destroy_context(ed_context *context);
+void ed_set_context(ed_context *context);
+ed_context *ed_get_context(void);
+struct ed_stats *ed_get_stats(void);
 void ed_register_update(ed_node *node, void (*update)(void));
 void ed_unregister_update(ed_node *node);
 void ed_update(unsigned update_every_n_frames);
+void ed_update_budget(unsigned budget_us, unsigned max_wait_frames);
 void ed_apply_system_colors(void);
 void ed_allocate_colors(void);
 void ed_resize(void *hwnd);
+void ed_mark_dirty(ed_node *node);
+void ed_set_backend(const ed_backend *backend);
+const ed_backend *ed_get_backend(void);
 void ed_invalidate(ed_node *node);
 void ed_invalidate_data(ed_node *node);
 void ed_str_data(ed_node *node, void *data, size_t size);
 void ed_data(ed_node *node, void *data);
+void ed_bind(ed_node *node, void *data);
+void ed_bind_version(ed_node *node, void *data, size_t size, const unsigned long long *version);
+void ed_unbind(ed_node *node);
+void ed_sync(void);
+void ed_notify_range(const void *data, size_t size);
+void ed_handle_str_data(ed_handle handle, void *data, size_t size);
+void ed_handle_data(ed_handle handle, void *data);
+void ed_handle_invalidate(ed_handle handle);
 
 void ed_begin_context(ed_node *node);
 void ed_end_context(void);
 void ed_insert_after(ed_node *node);
 void ed_remove(ed_node *node);
+void ed_handle_remove(ed_handle handle);
 void ed_attach_hwnd(ed_node *node, const char *class_name, const char *name, int flags);
 void ed_push_rect(float x, float y, float w, float h);
 ed_rect ed_pop_rect(float x, float y, float w, float h);
@@ -272,7 +413,11 @@ ed_rect ed_pop_rect(float x, float y, float w, float h);
 
 ed_node *ed_begin(ed_node_layout layout, float x, float y, float w, float h);
 ed_node *ed_begin_border(ed_node_layout layout, float x, float y, float w, float h);
+ed_node *ed_begin_grid(int column_count, const float *weights, float x, float y, float w, float h);
 ed_node *ed_begin_scroll(ed_node_layout layout);
+ed_node *ed_list(int row_count, float row_height, void (*build)(ed_node *row),
+        void (*bind)(ed_node *row, int index));
+void ed_list_set_count(ed_node *node, int row_count);
 ed_node *ed_begin_window(const char *name, ed_node_layout layout, float x, float y, float w, float h);
 ed_node *ed_begin_group(const char *name, ed_node_layout layout, float x, float y, float w, float h);
 ed_node *ed_begin_button(float x, float y, float w, float h, void (*onclick)(ed_node *node));
@@ -333,10 +478,19 @@ void ed_collapse(ed_node *node);
 void ed_readonly(ed_node *node);
 void ed_readwrite(ed_node *node);
 
+// Node state changes through handles
+
+void ed_handle_show(ed_handle handle);
+void ed_handle_hide(ed_handle handle);
+void ed_handle_enable(ed_handle handle);
+void ed_handle_disable(ed_handle handle);
+
 extern struct ed_style ed_style;
+
+// Statistics and update functions of the default context. Use `ed_get_stats`
+// for the current context.
 extern struct ed_stats ed_stats;
 
-extern ed_node ed_tree[ED_NODE_COUNT];
 extern ed_node_update ed_update_funcs[ED_UPDATE_FUNCS_COUNT];
 
 #ifdef __cplusplus
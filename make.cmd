@@ -19,3 +19,13 @@ link /nologo /debug:full /subsystem:windows user32.lib gdi32.lib comctl32.lib ms
 if "%1"=="/r" (
     start test.exe
 )
+
+rem Benchmarks: make.cmd /b
+if "%1"=="/b" (
+    cl /nologo /D_CRT_SECURE_NO_WARNINGS /DNOMINMAX /DWIN32_LEAN_AND_MEAN /O2 /W4 /std:c11 /I. ^
+        /Fobench\ /Fe:bench\bench.exe edwin.c bench\bench.c ^
+        user32.lib gdi32.lib comctl32.lib msimg32.lib
+
+    if errorlevel 1 exit /b 1
+    bench\bench.exe
+)